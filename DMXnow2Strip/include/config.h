@@ -26,8 +26,14 @@
 #define LED_COLOR_ORDER GRB
 #define LED_BRIGHTNESS 128
 #define LED_TARGET_FPS 60
+#define LED_MIN_FPS 2      // Keep-alive rate while the look is static
+#define LED_MAX_FPS 0      // Fast-motion ceiling, 0 = strip wire-time limit
 #define LED_RMT_CHANNEL 0
 
+// The render task owns presentation; loop() sleeps until a packet arrives
+// or this tick elapses (MeshClock sync, button, timeouts)
+#define RECEIVER_TICK_MS 10
+
 // ========================================
 // DMX Configuration
 // ========================================
@@ -35,9 +41,27 @@
 #ifndef DMX_UNIVERSE_ID
 #define DMX_UNIVERSE_ID 0
 #endif
+// 1-based address of this node's 32-channel zone; NVS overrides it at boot
+#ifndef DMX_START_ADDRESS
 #define DMX_START_ADDRESS 1
+#endif
+
+// Compact state frames are applied at sender mesh time + this delay so all
+// receivers switch together; must exceed worst-case air + retry latency.
+// 0 applies frames on arrival.
+#ifndef DMX_PLAYOUT_DELAY_MS
+#define DMX_PLAYOUT_DELAY_MS 40
+#endif
 
-// DMX Channel Layout (must match Midi2DMXnow)
+// Direct pixel streaming: frames arrive as LeslieProtocol pixel chunks on
+// consecutive universes from PIXEL_STREAM_UNIVERSE and replace the
+// parametric look while they keep coming
+#ifndef PIXEL_STREAM_UNIVERSE
+#define PIXEL_STREAM_UNIVERSE 1
+#endif
+#define PIXEL_STREAM_TIMEOUT_MS 1000
+
+// DMX Channel Layout, relative to DMX_START_ADDRESS (must match Midi2DMXnow)
 #define DMX_CH_MASTER_BRIGHTNESS 0
 #define DMX_CH_ANIMATION_MODE 1
 #define DMX_CH_ANIMATION_SPEED 2
@@ -57,6 +81,9 @@
 #define DMX_CH_COLOR_B_VALUE 14
 #define DMX_CH_COLOR_B_WHITE 15
 
+// Fine (LSB) byte of channel N at N + 16; used for brightness, speed and hues
+#define DMX_CH_FINE_OFFSET 16
+
 // ========================================
 // Debug Configuration
 // ========================================
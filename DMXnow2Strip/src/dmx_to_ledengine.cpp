@@ -1,4 +1,5 @@
 #include "dmx_to_ledengine.h"
+#include <LeslieProtocol.h>
 
 using namespace LedEngineLib;
 
@@ -24,16 +25,103 @@ DirectionMode decodeDirection(uint8_t value) {
 DMXToLedEngine::DMXToLedEngine()
     : _state()
     , _hasState(false)
-    , _colorA_H(0), _colorA_S(255), _colorA_V(255), _colorA_W(0)
-    , _colorB_H(160), _colorB_S(255), _colorB_V(255), _colorB_W(0) {
+    , _startAddress(DMX_START_ADDRESS)
+    , _prefsReady(false)
+    , _stateVersion(0)
+    , _framesDecoded(0)
+    , _framesSuppressed(0) {
+    memset(&_zone, 0, sizeof(_zone));
+}
+
+DMXToLedEngine::~DMXToLedEngine() {
+    if (_prefsReady) {
+        _preferences.end();
+        _prefsReady = false;
+    }
+}
+
+void DMXToLedEngine::begin() {
+    if (!_prefsReady) {
+        _prefsReady = _preferences.begin(NODE_STORAGE_NAMESPACE, false);
+    }
+    if (_prefsReady) {
+        uint16_t stored = _preferences.getUShort(START_ADDRESS_KEY, DMX_START_ADDRESS);
+        if (LeslieProtocol::isValidStartAddress(stored)) {
+            _startAddress = stored;
+        }
+    }
+
+    #if DEBUG_MODE
+    Serial.printf("DMX zone: channels %u-%u\n", _startAddress,
+                  _startAddress + LeslieProtocol::kStateChannels - 1);
+    #endif
+}
+
+bool DMXToLedEngine::setStartAddress(uint16_t address, bool persist) {
+    if (!LeslieProtocol::isValidStartAddress(address)) {
+        return false;
+    }
+    _startAddress = address;
+    if (persist && _prefsReady) {
+        _preferences.putUShort(START_ADDRESS_KEY, address);
+    }
+    return true;
 }
 
 void DMXToLedEngine::applyDMXFrame(const uint8_t* dmxData, uint16_t size) {
-    if (size < 16) {
-        return;
+    applyZone(zoneSlice(dmxData, size));
+}
+
+namespace {
+
+bool colorChanged(const uint8_t* before, const uint8_t* after, uint8_t firstChannel) {
+    return memcmp(before + firstChannel, after + firstChannel, 4) != 0 ||
+           before[firstChannel + DMX_CH_FINE_OFFSET] != after[firstChannel + DMX_CH_FINE_OFFSET];
+}
+
+uint16_t hue16(const uint8_t* zone, uint8_t channel) {
+    return static_cast<uint16_t>((zone[channel] << 8) | zone[channel + DMX_CH_FINE_OFFSET]);
+}
+
+bool sameBlock(const uint64_t* a, const uint64_t* b, size_t words) {
+    for (size_t i = 0; i < words; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+const uint8_t* DMXToLedEngine::zoneSlice(const uint8_t* dmxData, uint16_t size) const {
+    uint16_t offset = _startAddress - 1;
+    if (!dmxData || size < offset + LeslieProtocol::kStateChannels) {
+        return nullptr;
+    }
+    return dmxData + offset;
+}
+
+bool DMXToLedEngine::applyZone(const uint8_t* dmxData) {
+    if (!dmxData) {
+        return false;
+    }
+
+    decltype(_zone) incoming;
+    memcpy(incoming.bytes, dmxData, sizeof(incoming.bytes));
+    if (_hasState && sameBlock(incoming.words, _zone.words, sizeof(_zone.words) / sizeof(_zone.words[0]))) {
+        _framesSuppressed++;
+        return false;
     }
 
+    // HSV conversion only for the colour whose channels moved
+    const bool updateColorA = !_hasState || colorChanged(_zone.bytes, incoming.bytes, DMX_CH_COLOR_A_HUE);
+    const bool updateColorB = !_hasState || colorChanged(_zone.bytes, incoming.bytes, DMX_CH_COLOR_B_HUE);
+    _zone = incoming;
+    dmxData = _zone.bytes;
+
     _state.masterBrightness = dmxData[DMX_CH_MASTER_BRIGHTNESS];
+    _state.masterBrightnessFine = dmxData[DMX_CH_MASTER_BRIGHTNESS + DMX_CH_FINE_OFFSET];
 
     uint8_t modeValue = dmxData[DMX_CH_ANIMATION_MODE] / 25;
     if (modeValue >= ANIM_MODE_COUNT) {
@@ -42,25 +130,40 @@ void DMXToLedEngine::applyDMXFrame(const uint8_t* dmxData, uint16_t size) {
     _state.mode = static_cast<AnimationMode>(modeValue);
 
     _state.animationSpeed = dmxData[DMX_CH_ANIMATION_SPEED];
+    _state.animationSpeedFine = dmxData[DMX_CH_ANIMATION_SPEED + DMX_CH_FINE_OFFSET];
     _state.animationCtrl = dmxData[DMX_CH_ANIMATION_CTRL];
     _state.strobeRate = dmxData[DMX_CH_STROBE_RATE];
     _state.blendMode = dmxData[DMX_CH_BLEND_MODE];
     _state.mirror = decodeMirror(dmxData[DMX_CH_MIRROR_MODE]);
     _state.direction = decodeDirection(dmxData[DMX_CH_DIRECTION]);
 
-    _colorA_H = dmxData[DMX_CH_COLOR_A_HUE];
-    _colorA_S = dmxData[DMX_CH_COLOR_A_SATURATION];
-    _colorA_V = dmxData[DMX_CH_COLOR_A_VALUE];
-    _colorA_W = dmxData[DMX_CH_COLOR_A_WHITE];
-
-    _state.colorA.fromHSV(_colorA_H, _colorA_S, _colorA_V, _colorA_W);
-
-    _colorB_H = dmxData[DMX_CH_COLOR_B_HUE];
-    _colorB_S = dmxData[DMX_CH_COLOR_B_SATURATION];
-    _colorB_V = dmxData[DMX_CH_COLOR_B_VALUE];
-    _colorB_W = dmxData[DMX_CH_COLOR_B_WHITE];
-
-    _state.colorB.fromHSV(_colorB_H, _colorB_S, _colorB_V, _colorB_W);
+    if (updateColorA) {
+        _state.colorA.fromHSV16(hue16(dmxData, DMX_CH_COLOR_A_HUE), dmxData[DMX_CH_COLOR_A_SATURATION],
+                                dmxData[DMX_CH_COLOR_A_VALUE], dmxData[DMX_CH_COLOR_A_WHITE]);
+    }
+    if (updateColorB) {
+        _state.colorB.fromHSV16(hue16(dmxData, DMX_CH_COLOR_B_HUE), dmxData[DMX_CH_COLOR_B_SATURATION],
+                                dmxData[DMX_CH_COLOR_B_VALUE], dmxData[DMX_CH_COLOR_B_WHITE]);
+    }
 
     _hasState = true;
+    _framesDecoded++;
+    _stateVersion++;
+    return true;
+}
+
+bool DMXToLedEngine::applyTempo(const LeslieProtocol::TempoInfo& tempo, bool sync) {
+    sync = sync && tempo.beatPeriodUs != 0;
+    if (sync == _state.tempoSync && tempo.beatPeriodUs == _state.beatPeriodUs &&
+        tempo.beatEpochMs == _state.beatEpochMs && tempo.beatIndex == _state.beatIndex) {
+        return false;
+    }
+    _state.tempoSync = sync;
+    _state.beatPeriodUs = tempo.beatPeriodUs;
+    _state.beatEpochMs = tempo.beatEpochMs;
+    _state.beatIndex = tempo.beatIndex;
+    if (_hasState) {
+        _stateVersion++;
+    }
+    return true;
 }
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include <LedEngine.h>
+#include <Preferences.h>
+#include <LeslieProtocol.h>
 #include "config.h"
 
 /**
@@ -11,18 +13,52 @@
 class DMXToLedEngine {
 public:
     DMXToLedEngine();
+    ~DMXToLedEngine();
 
+    // Loads the zone start address from NVS, falling back to DMX_START_ADDRESS
+    void begin();
+
+    // Full universe: decodes the 32 channels at the zone start address
     void applyDMXFrame(const uint8_t* dmxData, uint16_t size);
+    // Full universe: returns this node's 32-channel block, or nullptr if the
+    // frame is too short. Cheap enough for the receive callback.
+    const uint8_t* zoneSlice(const uint8_t* dmxData, uint16_t size) const;
+    // Single zone block (compact packet): channels are already zone-relative.
+    // Returns false (and does no decoding) if the block matches the last one.
+    bool applyZone(const uint8_t* zoneData);
+    // Beat grid from a compact packet; sync is the packet's kFlagTempoSync.
+    // Returns false if nothing changed.
+    bool applyTempo(const LeslieProtocol::TempoInfo& tempo, bool sync);
+
+    // Increments only when an applied block changes the state
+    uint32_t getStateVersion() const { return _stateVersion; }
+    uint32_t getFramesDecoded() const { return _framesDecoded; }
+    uint32_t getFramesSuppressed() const { return _framesSuppressed; }
+
+    uint16_t getStartAddress() const { return _startAddress; }
+    bool setStartAddress(uint16_t address, bool persist = true);
+
     bool hasState() const { return _hasState; }
     const LedEngineLib::LedEngineState& getState() const { return _state; }
 
 private:
     LedEngineLib::LedEngineState _state;
     bool _hasState;
+    uint16_t _startAddress;
+    Preferences _preferences;
+    bool _prefsReady;
+
+    static constexpr const char* NODE_STORAGE_NAMESPACE = "dmxNode";
+    static constexpr const char* START_ADDRESS_KEY = "startAddr";
 
-    // Last received values (for HSV reconstruction)
-    uint8_t _colorA_H, _colorA_S, _colorA_V, _colorA_W;
-    uint8_t _colorB_H, _colorB_S, _colorB_V, _colorB_W;
+    // Last applied block; compared as four 64-bit words per frame
+    union {
+        uint8_t bytes[LeslieProtocol::kStateChannels];
+        uint64_t words[LeslieProtocol::kStateChannels / 8];
+    } _zone;
+    uint32_t _stateVersion;
+    uint32_t _framesDecoded;
+    uint32_t _framesSuppressed;
 };
 
 #endif // DMX_TO_LEDENGINE_H
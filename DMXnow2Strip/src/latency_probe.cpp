@@ -0,0 +1,78 @@
+#include "latency_probe.h"
+
+LatencyProbe::LatencyProbe()
+    : _probe()
+    , _rxUs(0)
+    , _playUs(0)
+    , _engineUs(0)
+    , _txUs(0)
+    , _stage(STAGE_IDLE)
+    , _completed(0)
+    , _lock(portMUX_INITIALIZER_UNLOCKED) {
+}
+
+void LatencyProbe::onReceive(const LeslieProtocol::ProbeInfo& probe, uint32_t nowUs) {
+    if (probe.id == 0) {
+        return;
+    }
+    portENTER_CRITICAL(&_lock);
+    // The controller repeats the latest probe, stamps unchanged, in every
+    // packet until the next
+    if (probe.id != _probe.id || probe.midiReadUs != _probe.midiReadUs) {
+        _probe = probe;
+        _rxUs = nowUs;
+        _stage = STAGE_RECEIVED;
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+bool LatencyProbe::onPlayout(uint8_t id, uint32_t nowUs) {
+    bool first = false;
+    portENTER_CRITICAL(&_lock);
+    if (id != 0 && _stage == STAGE_RECEIVED && id == _probe.id) {
+        _playUs = nowUs;
+        _stage = STAGE_PLAYED;
+        first = true;
+    }
+    portEXIT_CRITICAL(&_lock);
+    return first;
+}
+
+void LatencyProbe::onEngine(uint8_t id, uint32_t nowUs) {
+    portENTER_CRITICAL(&_lock);
+    if (_stage == STAGE_PLAYED && id == _probe.id) {
+        _engineUs = nowUs;
+        _stage = STAGE_ENGINE;
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+void LatencyProbe::onTransmit(uint8_t id, uint32_t transmitUs) {
+    portENTER_CRITICAL(&_lock);
+    if (_stage == STAGE_ENGINE && id == _probe.id) {
+        _txUs = transmitUs;
+        _stage = STAGE_TRANSMITTED;
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+bool LatencyProbe::report(Stream& out, uint32_t meshOffsetUs) {
+    portENTER_CRITICAL(&_lock);
+    if (_stage != STAGE_TRANSMITTED) {
+        portEXIT_CRITICAL(&_lock);
+        return false;
+    }
+    const LeslieProtocol::ProbeInfo probe = _probe;
+    const uint32_t rxUs = _rxUs + meshOffsetUs;
+    const uint32_t playUs = _playUs + meshOffsetUs;
+    const uint32_t engineUs = _engineUs + meshOffsetUs;
+    const uint32_t txUs = _txUs + meshOffsetUs;
+    _stage = STAGE_IDLE;
+    _completed++;
+    portEXIT_CRITICAL(&_lock);
+
+    out.printf("PROBE id=%u midi=%lu state=%lu sent=%lu rx=%lu play=%lu engine=%lu tx=%lu\n",
+               probe.id, probe.midiReadUs, probe.stateAppliedUs, probe.sentUs,
+               rxUs, playUs, engineUs, txUs);
+    return true;
+}
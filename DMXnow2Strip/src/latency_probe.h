@@ -0,0 +1,58 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <LeslieProtocol.h>
+
+/**
+ * LatencyProbe - Follows the controller's latency probes (CC_LATENCY_PROBE)
+ * through this receiver: packet arrival, playout into DMXToLedEngine,
+ * hand-off to LedEngine and the start of the strip transmit. A completed
+ * probe is reported as one line holding every hop, the controller's
+ * included, in mesh-clock microseconds:
+ *
+ *   PROBE id=<n> midi=<us> state=<us> sent=<us> rx=<us> play=<us> engine=<us> tx=<us>
+ *
+ * controller/test_midi_jitter.py turns these into per-hop percentiles.
+ * onReceive() runs in the ESP-NOW receive callback, the rest in loop().
+ */
+class LatencyProbe {
+public:
+    LatencyProbe();
+
+    // Every state packet; only the first arrival of a new id is recorded
+    void onReceive(const LeslieProtocol::ProbeInfo& probe, uint32_t nowUs);
+    // Played-out packet; true the first time a received id reaches playout
+    bool onPlayout(uint8_t id, uint32_t nowUs);
+    // State handed to the engine (or the engine marked) for that probe
+    void onEngine(uint8_t id, uint32_t nowUs);
+    // Stamp from LedEngine::takePresentedProbe()
+    void onTransmit(uint8_t id, uint32_t transmitUs);
+
+    // Prints and clears a completed probe. Local stamps are shifted into
+    // mesh time by meshOffsetUs (meshMillis() - millis(), in microseconds).
+    bool report(Stream& out, uint32_t meshOffsetUs);
+
+    uint32_t getCompleted() const { return _completed; }
+
+private:
+    LeslieProtocol::ProbeInfo _probe;  // Controller stamps (mesh time)
+    uint32_t _rxUs;                    // Local micros() from here on
+    uint32_t _playUs;
+    uint32_t _engineUs;
+    uint32_t _txUs;
+    uint8_t _stage;
+    uint32_t _completed;
+    mutable portMUX_TYPE _lock;
+
+    enum Stage : uint8_t {
+        STAGE_IDLE = 0,
+        STAGE_RECEIVED,
+        STAGE_PLAYED,
+        STAGE_ENGINE,
+        STAGE_TRANSMITTED
+    };
+};
+
+#endif // LATENCY_PROBE_H
@@ -0,0 +1,168 @@
+#include "link_monitor.h"
+
+constexpr uint16_t LinkMonitor::JITTER_BIN_LIMITS[];
+
+LinkMonitor::LinkMonitor()
+    : _lock(portMUX_INITIALIZER_UNLOCKED) {
+    memset(_tracks, 0, sizeof(_tracks));
+}
+
+LinkMonitor::Track* LinkMonitor::findTrack(uint8_t universe, uint16_t startAddress) {
+    for (uint8_t i = 0; i < MAX_TRACKS; i++) {
+        if (_tracks[i].used && _tracks[i].universe == universe && _tracks[i].startAddress == startAddress) {
+            return &_tracks[i];
+        }
+    }
+    for (uint8_t i = 0; i < MAX_TRACKS; i++) {
+        if (!_tracks[i].used) {
+            _tracks[i].used = true;
+            _tracks[i].universe = universe;
+            _tracks[i].startAddress = startAddress;
+            return &_tracks[i];
+        }
+    }
+    return nullptr;  // Table full; extra senders are not tracked
+}
+
+void LinkMonitor::recordPacket(uint8_t universe, uint16_t startAddress, uint16_t sequence,
+                               uint32_t stampMs, uint32_t nowMeshMs) {
+    portENTER_CRITICAL(&_lock);
+    Track* track = findTrack(universe, startAddress);
+    if (track) {
+        recordSequence(*track, sequence);
+        recordTransit(*track, stampMs, nowMeshMs);
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+void LinkMonitor::recordFrame(uint8_t universe) {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_lock);
+    Track* track = findTrack(universe, 0);
+    if (track) {
+        track->universeFrames++;
+        track->lastGoodMs = now;
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+void LinkMonitor::recordSequence(Track& track, uint16_t sequence) {
+    const uint32_t now = millis();
+    const bool silent = now - track.lastGoodMs > RESYNC_TIMEOUT_MS;
+    track.received++;
+    track.lastGoodMs = now;
+
+    int32_t delta = static_cast<int16_t>(sequence - track.highestSeq);
+    // A restarted sender can land anywhere relative to the old counter;
+    // what went missing across the restart is not link loss
+    if (!track.hasSequence || silent || delta >= RESYNC_GAP || -delta >= RESYNC_GAP) {
+        track.hasSequence = true;
+        track.highestSeq = sequence;
+        track.window = 1;
+        return;
+    }
+
+    if (delta > 0) {
+        track.lost += delta - 1;
+        track.window = (delta >= 32) ? 1 : ((track.window << delta) | 1);
+        track.highestSeq = sequence;
+    } else if (delta == 0) {
+        track.duplicates++;
+        track.received--;
+    } else if (-delta < 32) {
+        uint32_t bit = 1UL << (-delta);
+        if (track.window & bit) {
+            track.duplicates++;
+            track.received--;
+        } else {
+            // Counted as lost when the newer packet overtook it
+            track.window |= bit;
+            track.reordered++;
+            if (track.lost > 0) {
+                track.lost--;
+            }
+        }
+    } else {
+        track.reordered++;
+    }
+}
+
+void LinkMonitor::recordTransit(Track& track, uint32_t stampMs, uint32_t nowMeshMs) {
+    // Transit includes the fixed clock offset; only its variation matters
+    int32_t transit = static_cast<int32_t>(nowMeshMs - stampMs);
+    if (!track.hasTransit) {
+        track.hasTransit = true;
+        track.lastTransit = transit;
+        return;
+    }
+
+    int32_t d = transit - track.lastTransit;
+    track.lastTransit = transit;
+    uint32_t absD = d < 0 ? -d : d;
+
+    // J += (|D| - J) / 16, kept in Q4
+    track.jitterQ4 += absD - ((track.jitterQ4 + 8) >> 4);
+
+    uint8_t bin = 0;
+    while (bin < JITTER_BINS - 1 && absD >= JITTER_BIN_LIMITS[bin]) {
+        bin++;
+    }
+    track.histogram[bin]++;
+}
+
+uint8_t LinkMonitor::getTrackCount() const {
+    uint8_t count = 0;
+    portENTER_CRITICAL(&_lock);
+    for (uint8_t i = 0; i < MAX_TRACKS; i++) {
+        if (_tracks[i].used) {
+            count++;
+        }
+    }
+    portEXIT_CRITICAL(&_lock);
+    return count;
+}
+
+bool LinkMonitor::getStatus(uint8_t index, Status& out) const {
+    if (index >= MAX_TRACKS) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    const Track track = _tracks[index];
+    portEXIT_CRITICAL(&_lock);
+
+    if (!track.used) {
+        return false;
+    }
+
+    out.universe = track.universe;
+    out.startAddress = track.startAddress;
+    out.received = track.received;
+    out.universeFrames = track.universeFrames;
+    out.lost = track.lost;
+    out.duplicates = track.duplicates;
+    out.reordered = track.reordered;
+    uint32_t expected = track.received + track.lost;
+    out.lossPermille = expected ? static_cast<uint16_t>((static_cast<uint64_t>(track.lost) * 1000) / expected) : 0;
+    out.jitterMs = static_cast<uint16_t>((track.jitterQ4 + 8) >> 4);
+    out.msSinceLastGood = (track.received || track.universeFrames) ? millis() - track.lastGoodMs : UINT32_MAX;
+    memcpy(out.jitterHistogram, track.histogram, sizeof(out.jitterHistogram));
+    return true;
+}
+
+void LinkMonitor::printStatus(Stream& out) const {
+    Status status;
+    for (uint8_t i = 0; i < MAX_TRACKS; i++) {
+        if (!getStatus(i, status)) {
+            continue;
+        }
+        out.printf("Link U%u@%u: rx %lu (+%lu DMX), lost %lu (%u.%u%%), dup %lu, reord %lu, jitter %u ms, last %lu ms, hist",
+                   status.universe, status.startAddress, status.received, status.universeFrames, status.lost,
+                   status.lossPermille / 10, status.lossPermille % 10,
+                   status.duplicates, status.reordered, status.jitterMs, status.msSinceLastGood);
+        for (uint8_t bin = 0; bin < JITTER_BINS; bin++) {
+            out.printf("%c%lu", bin == 0 ? ' ' : '/', status.jitterHistogram[bin]);
+        }
+        out.println();
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef LINK_MONITOR_H
+#define LINK_MONITOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+/**
+ * LinkMonitor - Per-sender ESP-NOW link quality as seen by this receiver.
+ * Several controllers can share a universe at different start addresses,
+ * each with its own sequence counter, so compact state packets are tracked
+ * per (universe, start address) by sequence number (loss, duplicates,
+ * reordering) and by mesh-time transit jitter. Full-universe ESPNowDMX
+ * frames carry no sequence or stamp and only update arrival counters,
+ * under start address 0.
+ *
+ * Recording runs in the ESP-NOW receive callback, reading in loop().
+ */
+class LinkMonitor {
+public:
+    static constexpr uint8_t MAX_TRACKS = 8;
+    static constexpr uint8_t JITTER_BINS = 8;
+    // Upper bound (exclusive, ms) of each jitter bin; the last bin is open-ended
+    static constexpr uint16_t JITTER_BIN_LIMITS[JITTER_BINS - 1] = {2, 5, 10, 20, 50, 100, 200};
+
+    struct Status {
+        uint8_t universe;
+        uint16_t startAddress;      // 0 for full-universe frames
+        uint32_t received;          // Sequenced (compact) packets
+        uint32_t universeFrames;    // Unsequenced ESPNowDMX frames
+        uint32_t lost;
+        uint32_t duplicates;
+        uint32_t reordered;
+        uint16_t lossPermille;
+        uint16_t jitterMs;          // Smoothed |transit delta| (RFC 3550 style)
+        uint32_t msSinceLastGood;
+        uint32_t jitterHistogram[JITTER_BINS];
+    };
+
+    LinkMonitor();
+
+    // Compact packet with sequence number and sender mesh stamp
+    void recordPacket(uint8_t universe, uint16_t startAddress, uint16_t sequence,
+                      uint32_t stampMs, uint32_t nowMeshMs);
+    // Full-universe frame (no sequence/stamp available)
+    void recordFrame(uint8_t universe);
+
+    uint8_t getTrackCount() const;
+    bool getStatus(uint8_t index, Status& out) const;
+    void printStatus(Stream& out) const;
+
+private:
+    struct Track {
+        bool used;
+        bool hasSequence;
+        uint8_t universe;
+        uint16_t startAddress;
+        uint16_t highestSeq;
+        uint32_t window;     // Bit n set = (highestSeq - n) received
+        bool hasTransit;
+        int32_t lastTransit;
+        uint32_t jitterQ4;   // Jitter in ms, 4 fractional bits
+        uint32_t received;
+        uint32_t universeFrames;
+        uint32_t lost;
+        uint32_t duplicates;
+        uint32_t reordered;
+        uint32_t lastGoodMs;
+        uint32_t histogram[JITTER_BINS];
+    };
+
+    // Jumps this far from the newest sequence mean the sender restarted
+    static constexpr int32_t RESYNC_GAP = 1000;
+    // So does this much silence (three missed 500 ms keep-alives)
+    static constexpr uint32_t RESYNC_TIMEOUT_MS = 1500;
+
+    Track _tracks[MAX_TRACKS];
+    mutable portMUX_TYPE _lock;
+
+    Track* findTrack(uint8_t universe, uint16_t startAddress);
+    void recordSequence(Track& track, uint16_t sequence);
+    void recordTransit(Track& track, uint32_t stampMs, uint32_t nowMeshMs);
+};
+
+#endif // LINK_MONITOR_H
@@ -3,8 +3,14 @@
 #include <ESPNowDMX.h>
 #include <ESPNowMeshClock.h>
 #include <LedEngine.h>
+#include <LeslieProtocol.h>
 #include "config.h"
 #include "dmx_to_ledengine.h"
+#include "playout_buffer.h"
+#include "zone_mailbox.h"
+#include "link_monitor.h"
+#include "pixel_stream_receiver.h"
+#include "latency_probe.h"
 
 using namespace LedEngineLib;
 
@@ -17,20 +23,110 @@ DMXToLedEngine* dmxAdapter = nullptr;
 
 ESPNowDMX espnowDMX;
 ESPNowMeshClock meshClock;
+PlayoutBuffer playout;
+ZoneMailbox universeMailbox;
+LinkMonitor linkMonitor;
+PixelStreamReceiver pixelStream;
+LatencyProbe latencyProbe;
 
 bool dmxConnected = false;
-unsigned long lastDMXFrame = 0;
+volatile unsigned long lastDMXFrame = 0;
 const uint32_t DMX_TIMEOUT = 3000;
 
-// Callback for DMX frame reception
+// loop() blocks on notifications from the receive callbacks
+TaskHandle_t loopTaskHandle = nullptr;
+
+void wakeLoop() {
+    if (loopTaskHandle) {
+        xTaskNotifyGive(loopTaskHandle);
+    }
+}
+
+// Callback for DMX frame reception (Wi-Fi task): copy our zone into the
+// mailbox and return; loop() decodes it
 void onDMXFrameReceived(uint8_t universe, const uint8_t* data) {
-    (void)universe;
-    if (dmxAdapter && data) {
-        dmxAdapter->applyDMXFrame(data, DMX_UNIVERSE_SIZE);
-        dmxConnected = true;
+    linkMonitor.recordFrame(universe);
+    if (!dmxAdapter) {
+        return;
+    }
+    const uint8_t* zone = dmxAdapter->zoneSlice(data, DMX_UNIVERSE_SIZE);
+    if (zone) {
+        universeMailbox.publish(zone);
+        lastDMXFrame = millis();
+        wakeLoop();
+    }
+}
+
+// MeshClock hands us every non-clock ESP-NOW packet: compact LeslieProtocol
+// state packets are decoded here, everything else goes to ESPNowDMX.
+void onMeshPacket(const uint8_t* mac, const uint8_t* data, int len) {
+    if (!LeslieProtocol::isLesliePacket(data, len)) {
+        ESPNowDMX::forwardPacket(mac, data, len);
+        return;
+    }
+
+    if (const LeslieProtocol::PixelPacket* pixels = LeslieProtocol::asPixels(data, len)) {
+        pixelStream.onPixels(*pixels);
+        return;
+    }
+    if (const LeslieProtocol::SyncPacket* sync = LeslieProtocol::asSync(data, len)) {
+        if (sync->header.universe == PIXEL_STREAM_UNIVERSE) {
+            pixelStream.onSync(*sync);
+            wakeLoop();
+        }
+        return;
+    }
+
+    LeslieProtocol::StatePacket packet;
+    if (!LeslieProtocol::decodeState(data, len, packet)) {
+        return;
+    }
+    linkMonitor.recordPacket(packet.header.universe, packet.startAddress, packet.header.sequence,
+                             packet.meshTimeMs, meshClock.meshMillis());
+    if (packet.header.universe != DMX_UNIVERSE_ID) {
+        return;
+    }
+    // Other zones of the universe are addressed to other nodes
+    if (dmxAdapter && packet.startAddress == dmxAdapter->getStartAddress()) {
+        latencyProbe.onReceive(packet.probe, micros());
+        playout.push(packet, meshClock.meshMillis(), meshClock.getSyncState() == SyncState::SYNCED);
         lastDMXFrame = millis();
+        wakeLoop();
+    }
+}
+
+#if DEBUG_MODE
+// "addr <n>" on the serial console moves this node to another zone and
+// stores it in NVS, so a rack of identical builds can be addressed in place
+void handleSerialCommands() {
+    static char line[24];
+    static uint8_t lineLen = 0;
+
+    while (Serial.available()) {
+        char c = Serial.read();
+        if (c != '\n' && c != '\r') {
+            if (lineLen < sizeof(line) - 1) {
+                line[lineLen++] = c;
+            }
+            continue;
+        }
+        if (lineLen == 0) {
+            continue;
+        }
+        line[lineLen] = '\0';
+        lineLen = 0;
+
+        unsigned int address = 0;
+        if (sscanf(line, "addr %u", &address) == 1) {
+            if (dmxAdapter && dmxAdapter->setStartAddress(address)) {
+                Serial.printf("DMX start address set to %u\n", address);
+            } else {
+                Serial.printf("Invalid start address %u (1-%u)\n", address, LeslieProtocol::kMaxStartAddress);
+            }
+        }
     }
 }
+#endif
 
 // Quick RGBW test pattern so hardware faults are obvious during boot
 void playBootRGBWTest() {
@@ -94,8 +190,11 @@ void setup() {
     ledConfig.ledCount = LED_COUNT;
     ledConfig.dataPin = LED_DATA_PIN;
     ledConfig.targetFPS = LED_TARGET_FPS;
+    ledConfig.minFPS = LED_MIN_FPS;
+    ledConfig.maxFPS = LED_MAX_FPS;
     ledConfig.defaultBrightness = LED_BRIGHTNESS;
     ledConfig.enableRGBW = true;
+    ledConfig.directPixelMode = true;
     
     ledEngine = new LedEngine(ledConfig);
     ledEngine->begin();
@@ -103,9 +202,13 @@ void setup() {
     
     // Initialize DMX adapter
     dmxAdapter = new DMXToLedEngine();
+    dmxAdapter->begin();
+    pixelStream.begin(ledEngine, PIXEL_STREAM_UNIVERSE);
     
-    // Initialize MeshClock (owns ESP-NOW driver) and forward non-clock packets to the DMX receiver
-    meshClock.setUserCallback(ESPNowDMX::forwardPacket);
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+
+    // Initialize MeshClock (owns ESP-NOW driver) and route non-clock packets to state/DMX decoding
+    meshClock.setUserCallback(onMeshPacket);
     meshClock.begin(true);
 
     // Initialize ESPNow DMX receiver (reuse MeshClock's ESP-NOW instance)
@@ -159,13 +262,60 @@ void loop() {
         #endif
     }
     
-    // Update LED animations
-    if (ledEngine && dmxAdapter && dmxAdapter->hasState()) {
-        ledEngine->update(meshClock.meshMillis(), dmxAdapter->getState());
-        ledEngine->show();
+    // Decode on this thread: latest full-universe frame from the mailbox,
+    // then any buffered state frames whose playout time has come
+    // (identical blocks are suppressed by the adapter)
+    uint8_t zone[LeslieProtocol::kStateChannels];
+    if (dmxAdapter && universeMailbox.take(zone)) {
+        dmxAdapter->applyZone(zone);
+        dmxConnected = true;
+    }
+    LeslieProtocol::StatePacket packet;
+    uint8_t probeId = 0;
+    if (dmxAdapter && playout.popDue(meshClock.meshMillis(), packet)) {
+        dmxAdapter->applyZone(packet.channels);
+        dmxAdapter->applyTempo(packet.tempo, (packet.header.flags & LeslieProtocol::kFlagTempoSync) != 0);
+        if (latencyProbe.onPlayout(packet.probe.id, micros())) {
+            probeId = packet.probe.id;
+        }
+        dmxConnected = true;
+    }
+
+    // The render task presents frames on its own schedule; hand it new
+    // state when there is some and keep its clock anchored to mesh time
+    if (ledEngine) {
+        // Streamed pixels take over while frames keep arriving
+        bool streaming = pixelStream.isActive();
+        if (streaming != ledEngine->isDirectMode()) {
+            ledEngine->setDirectMode(streaming);
+            #if DEBUG_MODE
+                Serial.println(streaming ? "Pixel stream active" : "Pixel stream ended");
+            #endif
+        }
+        static uint32_t engineStateVersion = 0;
+        if (dmxAdapter && dmxAdapter->hasState() && dmxAdapter->getStateVersion() != engineStateVersion) {
+            engineStateVersion = dmxAdapter->getStateVersion();
+            ledEngine->update(meshClock.meshMillis(), dmxAdapter->getState());
+        } else {
+            ledEngine->syncClock(meshClock.meshMillis());
+        }
+
+        // A probe is done when the first frame built after it starts to go out
+        if (probeId != 0) {
+            latencyProbe.onEngine(probeId, micros());
+            ledEngine->markProbe(probeId);
+        }
+        uint8_t presentedId;
+        uint32_t transmitUs;
+        if (ledEngine->takePresentedProbe(presentedId, transmitUs)) {
+            latencyProbe.onTransmit(presentedId, transmitUs);
+        }
     }
     
     #if DEBUG_MODE
+        handleSerialCommands();
+        latencyProbe.report(Serial, (meshClock.meshMillis() - millis()) * 1000UL);
+
         static unsigned long lastDebug = 0;
         if (millis() - lastDebug > 5000) {
             lastDebug = millis();
@@ -175,13 +325,44 @@ void loop() {
                 case SyncState::SYNCED: syncState = "Synced"; break;
                 case SyncState::LOST: syncState = "Lost"; break;
             }
-            Serial.printf("DMX: %s, Clock: %lu ms, Sync: %s, FPS: %d\n",
+            Serial.printf("DMX: %s (addr %u), Clock: %lu ms, Sync: %s, FPS: %d (governor %u)\n",
                          dmxConnected ? "Connected" : "Waiting",
+                         dmxAdapter ? dmxAdapter->getStartAddress() : 0,
                          meshClock.meshMillis(),
                          syncState,
-                         ledEngine ? ledEngine->getFPS() : 0);
+                         ledEngine ? ledEngine->getFPS() : 0,
+                         ledEngine ? ledEngine->getGovernedFPS() : 0);
+            PlayoutBuffer::Stats ps = playout.getStats();
+            Serial.printf("Playout: delay %lu ms, rx %lu, played %lu, late %lu, early %lu, overflow %lu\n",
+                         playout.getDelay(), ps.received, ps.played, ps.late, ps.early, ps.overflow);
+            Serial.printf("Universe mailbox: rx %lu, overwritten %lu\n",
+                         universeMailbox.getPublished(), universeMailbox.getOverwritten());
+            Serial.printf("State: v%lu, decoded %lu, suppressed %lu\n",
+                         dmxAdapter->getStateVersion(), dmxAdapter->getFramesDecoded(),
+                         dmxAdapter->getFramesSuppressed());
+            linkMonitor.printStatus(Serial);
+            PixelStreamReceiver::Stats px = pixelStream.getStats();
+            if (px.chunks > 0) {
+                Serial.printf("Pixels: shown %lu (%lu key), incomplete %lu, no base %lu, chunks %lu, %lu%% of raw\n",
+                             px.framesShown, px.keyframes, px.incompleteFrames, px.waitingForKey, px.chunks,
+                             px.rawBytes ? (uint32_t)((uint64_t)px.encodedBytes * 100 / px.rawBytes) : 0);
+            }
+            strandTelemetry_t wire;
+            if (ledEngine && ledEngine->getStripTelemetry(wire)) {
+                Serial.printf("Wire: tx %lu/%lu us (avg/max), frame %lu us, max %u FPS, link %u%%, partial %lu, skipped %lu\n",
+                             wire.avgTxUs, wire.maxTxUs, wire.fullWireUs, wire.maxFps,
+                             wire.linkUtilizationPct, wire.partialFrames, wire.skippedFrames);
+            }
         }
     #endif
     
-    yield();
+    // Sleep until a packet arrives, the next buffered frame is due, or the
+    // housekeeping tick elapses
+    uint32_t waitMs = playout.msUntilDue(meshClock.meshMillis());
+    if (waitMs > RECEIVER_TICK_MS) {
+        waitMs = RECEIVER_TICK_MS;
+    }
+    if (waitMs > 0) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+    }
 }
@@ -0,0 +1,157 @@
+#include "pixel_stream_receiver.h"
+#include <algorithm>
+
+using LedEngineLib::CRGBW;
+using LeslieProtocol::kPixelChunkBytes;
+
+PixelStreamReceiver::PixelStreamReceiver()
+    : _engine(nullptr)
+    , _baseUniverse(0)
+    , _ledCount(0)
+    , _reference(nullptr)
+    , _referenceValid(false)
+    , _referenceFrameId(0)
+    , _referenceFormat(0)
+    , _decoder()
+    , _status(FRAME_IDLE)
+    , _frameId(0)
+    , _format(0)
+    , _keyframe(false)
+    , _nextChunk(0)
+    , _fedBytes(0)
+    , _lastFrameMs(0)
+    , _everShown(false)
+    , _stats() {
+}
+
+PixelStreamReceiver::~PixelStreamReceiver() {
+    delete[] _reference;
+    _reference = nullptr;
+}
+
+void PixelStreamReceiver::begin(LedEngineLib::LedEngine* engine, uint8_t baseUniverse) {
+    _engine = engine;
+    _baseUniverse = baseUniverse;
+    _ledCount = engine ? engine->getLedCount() : 0;
+    if (!_reference && _ledCount > 0) {
+        _reference = new uint8_t[static_cast<size_t>(_ledCount) * LeslieProtocol::PIXEL_RGBW]();
+    }
+}
+
+void PixelStreamReceiver::startFrame(const LeslieProtocol::PixelPacket& packet) {
+    if (_status == FRAME_DECODING) {
+        // Previous frame never got its sync
+        _stats.incompleteFrames++;
+        _referenceValid = false;
+    }
+
+    _frameId = packet.frameId;
+    _format = packet.format;
+    _keyframe = (packet.header.flags & LeslieProtocol::kFlagKeyframe) != 0;
+    _nextChunk = 0;
+    _fedBytes = 0;
+
+    if (!_keyframe && (!_referenceValid || packet.baseFrameId != _referenceFrameId ||
+                       packet.format != _referenceFormat)) {
+        _stats.waitingForKey++;
+        _status = FRAME_BROKEN;
+        return;
+    }
+
+    _decoder.begin(_reference, static_cast<size_t>(_ledCount) * _format, !_keyframe,
+                   static_cast<size_t>(LeslieProtocol::kMaxPixelChunks) * kPixelChunkBytes * 2);
+    _status = FRAME_DECODING;
+}
+
+void PixelStreamReceiver::breakFrame() {
+    if (_status == FRAME_DECODING) {
+        // The reference has been partially rewritten
+        _referenceValid = false;
+        _stats.incompleteFrames++;
+    }
+    _status = FRAME_BROKEN;
+}
+
+void PixelStreamReceiver::onPixels(const LeslieProtocol::PixelPacket& packet) {
+    if (!_engine || !_reference || !_engine->getDirectWriteBuffer()) {
+        return;
+    }
+
+    uint8_t universeIndex = packet.header.universe - _baseUniverse;
+    uint16_t chunkIndex = universeIndex * LeslieProtocol::kChunksPerUniverse + packet.chunk;
+    if (packet.header.universe < _baseUniverse || chunkIndex >= LeslieProtocol::kMaxPixelChunks) {
+        return;
+    }
+    _stats.chunks++;
+
+    if (_status == FRAME_IDLE || packet.frameId != _frameId) {
+        startFrame(packet);
+    }
+    if (_status != FRAME_DECODING) {
+        return;
+    }
+
+    // The decoder is streaming, so chunks must arrive in order; a gap or
+    // reorder costs this frame and the delta chain behind it
+    if (chunkIndex != _nextChunk || !_decoder.feed(packet.data, packet.length)) {
+        breakFrame();
+        return;
+    }
+    _nextChunk++;
+    _fedBytes += packet.length;
+}
+
+void PixelStreamReceiver::onSync(const LeslieProtocol::SyncPacket& packet) {
+    if (!_engine || !_reference) {
+        return;
+    }
+
+    bool complete = _status == FRAME_DECODING && packet.frameId == _frameId &&
+                    packet.format == _format && packet.encodedBytes == _fedBytes &&
+                    _decoder.atTokenBoundary() &&
+                    _decoder.decodedBytes() == static_cast<size_t>(packet.pixelCount) * packet.format;
+
+    if (complete) {
+        _referenceValid = true;
+        _referenceFrameId = _frameId;
+        _referenceFormat = _format;
+        if (_keyframe) {
+            _stats.keyframes++;
+        }
+        _stats.encodedBytes += _fedBytes;
+        _stats.rawBytes += _decoder.decodedBytes();
+
+        publishReference(packet.pixelCount < _ledCount ? packet.pixelCount : _ledCount);
+        _stats.framesShown++;
+        _lastFrameMs = millis();
+        _everShown = true;
+    } else if (_status == FRAME_DECODING) {
+        breakFrame();
+    }
+    _status = FRAME_IDLE;
+}
+
+void PixelStreamReceiver::publishReference(uint16_t pixels) {
+    CRGBW* frame = _engine->getDirectWriteBuffer();
+    if (!frame) {
+        return;
+    }
+
+    if (_referenceFormat == LeslieProtocol::PIXEL_RGBW) {
+        memcpy(frame, _reference, static_cast<size_t>(pixels) * sizeof(CRGBW));
+    } else {
+        const uint8_t* src = _reference;
+        for (uint16_t i = 0; i < pixels; ++i, src += 3) {
+            frame[i] = CRGBW(src[0], src[1], src[2], 0);
+        }
+    }
+    // Pixels the stream does not cover stay dark
+    if (pixels < _ledCount) {
+        std::fill(frame + pixels, frame + _ledCount, CRGBW());
+    }
+    _engine->commitDirectFrame();
+}
+
+bool PixelStreamReceiver::isActive() const {
+    return _everShown && (millis() - _lastFrameMs) < PIXEL_STREAM_TIMEOUT_MS;
+}
@@ -0,0 +1,78 @@
+#ifndef PIXEL_STREAM_RECEIVER_H
+#define PIXEL_STREAM_RECEIVER_H
+
+#include <Arduino.h>
+#include <LedEngine.h>
+#include <LeslieProtocol.h>
+#include <PixelCodec.h>
+#include "config.h"
+
+/**
+ * PixelStreamReceiver - Decodes keyframe/delta pixel frames from
+ * LeslieProtocol pixel chunks. Chunks are fed to a streaming PixelDecoder
+ * as they arrive, updating the reference frame in place; when the sync
+ * packet confirms a complete frame the reference is copied into the
+ * LedEngine direct write buffer and committed. Partial frames are never
+ * shown. Any gap invalidates the reference until the next keyframe.
+ *
+ * onPixels()/onSync() run in the ESP-NOW receive callback (single producer).
+ */
+class PixelStreamReceiver {
+public:
+    struct Stats {
+        uint32_t chunks;
+        uint32_t framesShown;
+        uint32_t keyframes;
+        uint32_t incompleteFrames;  // Chunk missing, out of order or malformed
+        uint32_t waitingForKey;     // Delta frames dropped without a valid base
+        uint32_t encodedBytes;      // Payload of shown frames
+        uint32_t rawBytes;          // What those frames would cost uncompressed
+    };
+
+    PixelStreamReceiver();
+    ~PixelStreamReceiver();
+
+    // Allocates the reference frame once; nothing is allocated afterwards
+    void begin(LedEngineLib::LedEngine* engine, uint8_t baseUniverse);
+
+    void onPixels(const LeslieProtocol::PixelPacket& packet);
+    void onSync(const LeslieProtocol::SyncPacket& packet);
+
+    // A complete frame was shown within PIXEL_STREAM_TIMEOUT_MS
+    bool isActive() const;
+    Stats getStats() const { return _stats; }
+
+private:
+    enum FrameStatus : uint8_t {
+        FRAME_IDLE,
+        FRAME_DECODING,
+        FRAME_BROKEN
+    };
+
+    LedEngineLib::LedEngine* _engine;
+    uint8_t _baseUniverse;
+    uint16_t _ledCount;
+
+    uint8_t* _reference;  // Last decoded frame in stream format
+    bool _referenceValid;
+    uint8_t _referenceFrameId;
+    uint8_t _referenceFormat;
+
+    LedEngineLib::PixelDecoder _decoder;
+    FrameStatus _status;
+    uint8_t _frameId;
+    uint8_t _format;
+    bool _keyframe;
+    uint16_t _nextChunk;
+    uint32_t _fedBytes;
+
+    volatile uint32_t _lastFrameMs;
+    volatile bool _everShown;
+    Stats _stats;
+
+    void startFrame(const LeslieProtocol::PixelPacket& packet);
+    void breakFrame();
+    void publishReference(uint16_t pixels);
+};
+
+#endif // PIXEL_STREAM_RECEIVER_H
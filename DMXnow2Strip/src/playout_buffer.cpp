@@ -0,0 +1,82 @@
+#include "playout_buffer.h"
+
+PlayoutBuffer::PlayoutBuffer()
+    : _head(0)
+    , _count(0)
+    , _delayMs(DMX_PLAYOUT_DELAY_MS)
+    , _stats()
+    , _lock(portMUX_INITIALIZER_UNLOCKED) {
+}
+
+void PlayoutBuffer::push(const LeslieProtocol::StatePacket& packet, uint32_t nowMeshMs, bool clockSynced) {
+    portENTER_CRITICAL(&_lock);
+    _stats.received++;
+
+    uint32_t dueMs = nowMeshMs;
+    if (clockSynced && _delayMs > 0) {
+        dueMs = packet.meshTimeMs + _delayMs;
+        if (isDue(dueMs, nowMeshMs)) {
+            _stats.late++;
+            dueMs = nowMeshMs;
+        } else if (static_cast<int32_t>(dueMs - nowMeshMs) > static_cast<int32_t>(_delayMs + MAX_EARLY_MS)) {
+            _stats.early++;
+            dueMs = nowMeshMs + _delayMs;
+        }
+    }
+
+    // Keep due times monotonic so a frame never overtakes a newer one
+    if (_count > 0) {
+        uint8_t tail = (_head + _count - 1) % SLOT_COUNT;
+        if (!isDue(_slots[tail].dueMs, dueMs)) {
+            dueMs = _slots[tail].dueMs;
+        }
+    }
+
+    if (_count == SLOT_COUNT) {
+        _head = (_head + 1) % SLOT_COUNT;
+        _count--;
+        _stats.overflow++;
+    }
+
+    Slot& slot = _slots[(_head + _count) % SLOT_COUNT];
+    slot.dueMs = dueMs;
+    slot.packet = packet;
+    _count++;
+    portEXIT_CRITICAL(&_lock);
+}
+
+bool PlayoutBuffer::popDue(uint32_t nowMeshMs, LeslieProtocol::StatePacket& packet) {
+    bool found = false;
+    portENTER_CRITICAL(&_lock);
+    while (_count > 0 && isDue(_slots[_head].dueMs, nowMeshMs)) {
+        if (found) {
+            _stats.superseded++;
+        }
+        packet = _slots[_head].packet;
+        found = true;
+        _head = (_head + 1) % SLOT_COUNT;
+        _count--;
+    }
+    if (found) {
+        _stats.played++;
+    }
+    portEXIT_CRITICAL(&_lock);
+    return found;
+}
+
+uint32_t PlayoutBuffer::msUntilDue(uint32_t nowMeshMs) const {
+    uint32_t wait = UINT32_MAX;
+    portENTER_CRITICAL(&_lock);
+    if (_count > 0) {
+        wait = isDue(_slots[_head].dueMs, nowMeshMs) ? 0 : _slots[_head].dueMs - nowMeshMs;
+    }
+    portEXIT_CRITICAL(&_lock);
+    return wait;
+}
+
+PlayoutBuffer::Stats PlayoutBuffer::getStats() const {
+    portENTER_CRITICAL(&_lock);
+    Stats copy = _stats;
+    portEXIT_CRITICAL(&_lock);
+    return copy;
+}
@@ -0,0 +1,67 @@
+#ifndef PLAYOUT_BUFFER_H
+#define PLAYOUT_BUFFER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <LeslieProtocol.h>
+#include "config.h"
+
+/**
+ * PlayoutBuffer - Holds mesh-time-stamped state packets until their
+ * playout time (meshTimeMs + DMX_PLAYOUT_DELAY_MS), so ESP-NOW retry and
+ * queue jitter do not turn into timing differences between receivers.
+ *
+ * push() runs in the ESP-NOW receive callback, popDue() in loop().
+ */
+class PlayoutBuffer {
+public:
+    struct Stats {
+        uint32_t received;
+        uint32_t played;
+        uint32_t late;       // Arrived after their playout time
+        uint32_t early;      // Stamped too far ahead (clock skew), clamped
+        uint32_t overflow;   // Dropped because the buffer was full
+        uint32_t superseded; // Replaced by a newer due frame before playout
+    };
+
+    PlayoutBuffer();
+
+    void setDelay(uint32_t delayMs) { _delayMs = delayMs; }
+    uint32_t getDelay() const { return _delayMs; }
+
+    // clockSynced=false plays the frame immediately (stamps are meaningless
+    // until the mesh clock has locked)
+    void push(const LeslieProtocol::StatePacket& packet, uint32_t nowMeshMs, bool clockSynced);
+
+    // Copies the newest packet whose playout time has passed; older due
+    // packets are dropped since the state is latest-wins.
+    bool popDue(uint32_t nowMeshMs, LeslieProtocol::StatePacket& packet);
+
+    // Milliseconds until the oldest pending frame is due, UINT32_MAX if empty
+    uint32_t msUntilDue(uint32_t nowMeshMs) const;
+
+    Stats getStats() const;
+
+private:
+    static constexpr uint8_t SLOT_COUNT = 8;
+    // Stamps further ahead than this beyond the delay are treated as skew
+    static constexpr uint32_t MAX_EARLY_MS = 250;
+
+    struct Slot {
+        uint32_t dueMs;
+        LeslieProtocol::StatePacket packet;
+    };
+
+    Slot _slots[SLOT_COUNT];
+    uint8_t _head;   // Oldest pending slot
+    uint8_t _count;
+    uint32_t _delayMs;
+    Stats _stats;
+    mutable portMUX_TYPE _lock;
+
+    static bool isDue(uint32_t dueMs, uint32_t nowMs) {
+        return static_cast<int32_t>(nowMs - dueMs) >= 0;
+    }
+};
+
+#endif // PLAYOUT_BUFFER_H
@@ -0,0 +1,75 @@
+#ifndef ZONE_MAILBOX_H
+#define ZONE_MAILBOX_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <LeslieProtocol.h>
+
+/**
+ * ZoneMailbox - Lock-free, latest-wins hand-off of one 32-channel zone from
+ * the ESP-NOW receive callback (single producer) to loop() (single
+ * consumer). A sequence lock guards the payload: the producer makes the
+ * sequence odd while writing, the consumer retries if it saw an odd or
+ * changing sequence. The callback never blocks and never decodes.
+ */
+class ZoneMailbox {
+public:
+    ZoneMailbox() : _sequence(0), _published(0), _overwritten(0), _consumedSeq(0) {
+        for (uint8_t i = 0; i < LeslieProtocol::kStateChannels; i++) {
+            _channels[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer side (receive callback)
+    void publish(const uint8_t* channels) {
+        uint32_t seq = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (uint8_t i = 0; i < LeslieProtocol::kStateChannels; i++) {
+            _channels[i].store(channels[i], std::memory_order_relaxed);
+        }
+        _sequence.store(seq + 2, std::memory_order_release);
+        _published.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumer side (loop). Returns true with a consistent copy if a frame
+    // was published since the last successful take().
+    bool take(uint8_t* channels) {
+        for (;;) {
+            uint32_t before = _sequence.load(std::memory_order_acquire);
+            if (before == _consumedSeq) {
+                return false;
+            }
+            if (before & 1) {
+                continue;  // Producer mid-write; it finishes within a few cycles
+            }
+            for (uint8_t i = 0; i < LeslieProtocol::kStateChannels; i++) {
+                channels[i] = _channels[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+            // Every publish advances the sequence by two
+            uint32_t frames = (before - _consumedSeq) / 2;
+            if (frames > 1) {
+                _overwritten += frames - 1;
+            }
+            _consumedSeq = before;
+            return true;
+        }
+    }
+
+    uint32_t getPublished() const { return _published.load(std::memory_order_relaxed); }
+    // Frames replaced by a newer one before loop() picked them up
+    uint32_t getOverwritten() const { return _overwritten; }
+
+private:
+    std::atomic<uint32_t> _sequence;
+    std::atomic<uint8_t> _channels[LeslieProtocol::kStateChannels];
+    std::atomic<uint32_t> _published;
+    uint32_t _overwritten;
+    uint32_t _consumedSeq;
+};
+
+#endif // ZONE_MAILBOX_H
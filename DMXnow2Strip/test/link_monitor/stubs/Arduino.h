@@ -0,0 +1,23 @@
+// Host stand-in for the parts of Arduino.h LinkMonitor uses
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Tests drive time by hand
+extern uint32_t g_hostMillis;
+inline uint32_t millis() { return g_hostMillis; }
+
+class Stream {
+public:
+    int printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        const int written = vprintf(format, args);
+        va_end(args);
+        return written;
+    }
+    void println() { putchar('\n'); }
+};
@@ -0,0 +1,7 @@
+// Host stand-in: single-threaded tests need no real critical sections
+#pragma once
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
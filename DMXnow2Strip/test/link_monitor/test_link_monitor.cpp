@@ -0,0 +1,167 @@
+// Host test for LinkMonitor sequence and per-sender tracking.
+// Build and run with `make` in this directory.
+#include "link_monitor.h"
+
+#include <stdlib.h>
+
+uint32_t g_hostMillis = 0;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK_EQ(actual, expected)                                              \
+    do {                                                                        \
+        const unsigned long a_ = (actual), e_ = (expected);                     \
+        if (a_ != e_) {                                                         \
+            printf("%s:%d: %s = %lu, expected %lu\n", __FILE__, __LINE__,       \
+                   #actual, a_, e_);                                            \
+            g_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+bool findStatus(const LinkMonitor& monitor, uint8_t universe, uint16_t startAddress,
+                LinkMonitor::Status& out) {
+    for (uint8_t i = 0; i < LinkMonitor::MAX_TRACKS; i++) {
+        if (monitor.getStatus(i, out) && out.universe == universe && out.startAddress == startAddress) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void feed(LinkMonitor& monitor, uint16_t startAddress, uint16_t sequence) {
+    monitor.recordPacket(0, startAddress, sequence, g_hostMillis, g_hostMillis + 3);
+}
+
+void testInOrderAcrossWrap() {
+    LinkMonitor monitor;
+    for (uint32_t i = 0; i < 200; i++) {
+        feed(monitor, 1, static_cast<uint16_t>(65500 + i));
+    }
+    LinkMonitor::Status status;
+    CHECK_EQ(findStatus(monitor, 0, 1, status), true);
+    CHECK_EQ(status.received, 200);
+    CHECK_EQ(status.lost, 0);
+    CHECK_EQ(status.duplicates, 0);
+    CHECK_EQ(status.reordered, 0);
+}
+
+void testLossDuplicateReorder() {
+    LinkMonitor monitor;
+    const uint16_t sequence[] = {1, 2, 3, 5, 4, 4, 6, 9, 9, 10};
+    for (uint16_t seq : sequence) {
+        feed(monitor, 1, seq);
+    }
+    LinkMonitor::Status status;
+    CHECK_EQ(findStatus(monitor, 0, 1, status), true);
+    CHECK_EQ(status.received, 8);     // 1-6, 9, 10
+    CHECK_EQ(status.lost, 2);         // 7, 8
+    CHECK_EQ(status.duplicates, 2);   // Second 4 and 9
+    CHECK_EQ(status.reordered, 1);    // 4 after 5
+}
+
+void testSharedUniverseSenders() {
+    // Two controllers on universe 0 at different zones, interleaved, with
+    // unrelated sequence counters
+    LinkMonitor monitor;
+    for (uint16_t i = 0; i < 500; i++) {
+        feed(monitor, 1, static_cast<uint16_t>(100 + i));
+        feed(monitor, 33, static_cast<uint16_t>(40000 + i));
+    }
+    LinkMonitor::Status status;
+    CHECK_EQ(monitor.getTrackCount(), 2);
+    CHECK_EQ(findStatus(monitor, 0, 1, status), true);
+    CHECK_EQ(status.received, 500);
+    CHECK_EQ(status.lost, 0);
+    CHECK_EQ(status.duplicates, 0);
+    CHECK_EQ(findStatus(monitor, 0, 33, status), true);
+    CHECK_EQ(status.received, 500);
+    CHECK_EQ(status.lost, 0);
+    CHECK_EQ(status.duplicates, 0);
+}
+
+void testUniverseFramesSeparate() {
+    LinkMonitor monitor;
+    feed(monitor, 1, 7);
+    monitor.recordFrame(0);
+    monitor.recordFrame(0);
+    LinkMonitor::Status status;
+    CHECK_EQ(findStatus(monitor, 0, 0, status), true);
+    CHECK_EQ(status.universeFrames, 2);
+    CHECK_EQ(status.received, 0);
+    CHECK_EQ(findStatus(monitor, 0, 1, status), true);
+    CHECK_EQ(status.universeFrames, 0);
+    CHECK_EQ(status.received, 1);
+}
+
+void testSenderRestart() {
+    LinkMonitor monitor;
+    for (uint16_t i = 0; i < 3000; i++) {
+        feed(monitor, 1, i);
+    }
+    // Reboot: the counter starts over far behind the newest sequence
+    for (uint16_t i = 0; i < 10; i++) {
+        feed(monitor, 1, i);
+    }
+    LinkMonitor::Status status;
+    CHECK_EQ(findStatus(monitor, 0, 1, status), true);
+    CHECK_EQ(status.lost, 0);
+    CHECK_EQ(status.duplicates, 0);
+}
+
+void testSenderRestartFromHighSequence() {
+    LinkMonitor monitor;
+    for (uint32_t i = 0; i < 100; i++) {
+        feed(monitor, 1, static_cast<uint16_t>(40000 + i));
+    }
+    // 0 - 40099 is a positive int16 delta; it must not count as ~25k lost
+    for (uint16_t i = 0; i < 10; i++) {
+        feed(monitor, 1, i);
+    }
+    feed(monitor, 1, 11);
+    LinkMonitor::Status status;
+    CHECK_EQ(findStatus(monitor, 0, 1, status), true);
+    CHECK_EQ(status.received, 111);
+    CHECK_EQ(status.lost, 1);         // 10, after the resync
+    CHECK_EQ(status.reordered, 0);
+}
+
+void testSenderRestartAfterSilence() {
+    LinkMonitor monitor;
+    for (uint16_t i = 0; i < 500; i++) {
+        feed(monitor, 1, i);
+        g_hostMillis += 20;
+    }
+    // Reboot: the counter restarts less than RESYNC_GAP behind
+    g_hostMillis += 2000;
+    for (uint16_t i = 0; i < 10; i++) {
+        feed(monitor, 1, i);
+        g_hostMillis += 20;
+    }
+    feed(monitor, 1, 12);
+    LinkMonitor::Status status;
+    CHECK_EQ(findStatus(monitor, 0, 1, status), true);
+    CHECK_EQ(status.received, 511);
+    CHECK_EQ(status.lost, 2);         // 10 and 11, tracked again
+    CHECK_EQ(status.duplicates, 0);
+    CHECK_EQ(status.reordered, 0);
+}
+
+}
+
+int main() {
+    testInOrderAcrossWrap();
+    testLossDuplicateReorder();
+    testSharedUniverseSenders();
+    testUniverseFramesSeparate();
+    testSenderRestart();
+    testSenderRestartFromHighSequence();
+    testSenderRestartAfterSilence();
+    if (g_failures) {
+        printf("%d check(s) failed\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    printf("link_monitor: all checks passed\n");
+    return EXIT_SUCCESS;
+}
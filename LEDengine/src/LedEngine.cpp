@@ -1,10 +1,12 @@
 #include "LedEngine.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
 
 #if defined(ARDUINO_ARCH_ESP32)
+#include <esp_log.h>
 #include <esp_random.h>
 #endif
 
@@ -14,8 +16,24 @@ namespace {
 
 constexpr float LEDENGINE_TWO_PI = 6.28318530718f;
 
+// Unchanged frames in a row before the governor falls back to minFPS.
+constexpr uint16_t kStaticFramesBeforeIdle = 3;
+
 bool g_rmtInitialized = false;
 
+// Modes whose output follows _animationPhase
+bool isPhaseDriven(AnimationMode mode) {
+    switch (mode) {
+        case ANIM_CHASE:
+        case ANIM_DASH:
+        case ANIM_WAVEFORM:
+        case ANIM_RAINBOW:
+            return true;
+        default:
+            return false;
+    }
+}
+
 uint32_t nextRandom32() {
 #if defined(ARDUINO_ARCH_ESP32)
     return esp_random();
@@ -64,15 +82,9 @@ uint8_t random8(uint8_t maxExclusive) {
     return static_cast<uint8_t>(nextRandom32() % maxExclusive);
 }
 
-void hsvToRgb(uint8_t hue, uint8_t sat, uint8_t val, uint8_t& r, uint8_t& g, uint8_t& b) {
-    if (sat == 0) {
-        r = g = b = val;
-        return;
-    }
-
-    uint8_t region = hue / 43;
-    uint8_t remainder = (hue - (region * 43)) * 6;
-
+// region 0-5 of the colour wheel, remainder 0-255 within the region
+void hsvRegionToRgb(uint8_t region, uint8_t remainder, uint8_t sat, uint8_t val,
+                    uint8_t& r, uint8_t& g, uint8_t& b) {
     uint16_t p = (static_cast<uint16_t>(val) * (255 - sat)) >> 8;
     uint16_t q = (static_cast<uint16_t>(val) * (255 - ((static_cast<uint16_t>(sat) * remainder) >> 8))) >> 8;
     uint16_t t = (static_cast<uint16_t>(val) * (255 - ((static_cast<uint16_t>(sat) * (255 - remainder)) >> 8))) >> 8;
@@ -111,6 +123,31 @@ void hsvToRgb(uint8_t hue, uint8_t sat, uint8_t val, uint8_t& r, uint8_t& g, uin
     }
 }
 
+void hsvToRgb(uint8_t hue, uint8_t sat, uint8_t val, uint8_t& r, uint8_t& g, uint8_t& b) {
+    if (sat == 0) {
+        r = g = b = val;
+        return;
+    }
+
+    uint8_t region = hue / 43;
+    uint8_t remainder = (hue - (region * 43)) * 6;
+    hsvRegionToRgb(region, remainder, sat, val, r, g, b);
+}
+
+// Regions are 43 hue steps wide as above, so 8- and 16-bit hues agree on
+// whole steps; the fraction refines the remainder from steps of 6 to 1.
+void hsvToRgb16(uint16_t hue, uint8_t sat, uint8_t val, uint8_t& r, uint8_t& g, uint8_t& b) {
+    if (sat == 0) {
+        r = g = b = val;
+        return;
+    }
+
+    constexpr uint16_t kRegionWidth = 43 << 8;
+    uint8_t region = hue / kRegionWidth;
+    uint32_t remainder = (static_cast<uint32_t>(hue - region * kRegionWidth) * 6) >> 8;
+    hsvRegionToRgb(region, remainder > 255 ? 255 : static_cast<uint8_t>(remainder), sat, val, r, g, b);
+}
+
 uint8_t clampByte(int value) {
     if (value < 0) return 0;
     if (value > 255) return 255;
@@ -124,6 +161,11 @@ void ColorRGBW::fromHSV(uint8_t hue, uint8_t sat, uint8_t val, uint8_t white) {
     w = white;
 }
 
+void ColorRGBW::fromHSV16(uint16_t hue, uint8_t sat, uint8_t val, uint8_t white) {
+    hsvToRgb16(hue, sat, val, r, g, b);
+    w = white;
+}
+
 CRGB ColorRGBW::toCRGB() const {
     return CRGB(r, g, b);
 }
@@ -140,6 +182,10 @@ LedEngine::LedEngine(const LedEngineConfig& config)
       _animationPhase(0),
       _lastUpdateClock(0),
       _frameIntervalMs(config.targetFPS == 0 ? 16 : 1000 / config.targetFPS),
+      _phaseStep(0),
+      _phaseFraction(0),
+      _staticFrames(0),
+      _presentedBrightness(-1),
       _frameCount(0),
       _fpsTimer(0),
       _fps(0),
@@ -147,7 +193,16 @@ LedEngine::LedEngine(const LedEngineConfig& config)
       _stateMutex(nullptr),
       _bufferMutex(nullptr),
       _stateDirty(false),
-      _pendingClockMillis(0) {
+      _clockOffset(0),
+      _directBuffers{nullptr, nullptr, nullptr},
+      _directWrite(0),
+      _directFront(1),
+      _directReady(2),
+      _directMode(false),
+      _pendingProbe(0),
+      _renderProbe(0),
+      _presentedProbeUs(0),
+      _presentedProbe(0) {
     _state.masterBrightness = _config.defaultBrightness;
     _state.colorA = ColorRGBW(0, 0, 0, 0);
     _state.colorB = ColorRGBW(0, 0, 0, 0);
@@ -172,6 +227,8 @@ LedEngine::~LedEngine() {
     delete[] _renderBuffer;
     _renderBuffer = nullptr;
     _hwBuffer = nullptr;
+    delete[] _directBuffers[0];
+    _directBuffers[0] = _directBuffers[1] = _directBuffers[2] = nullptr;
     delete[] _previewBuffer;
     _previewBuffer = nullptr;
     if (_strand) {
@@ -200,6 +257,10 @@ bool LedEngine::begin() {
         g_rmtInitialized = true;
     }
 
+    if (_config.rmtStrandsPlanned > 0) {
+        LibStrip::reserveStrands(_config.rmtStrandsPlanned);
+    }
+
     led_types ledType = _config.enableRGBW ? LED_SK6812W_V4 : LED_SK6812_V1;
     if (_config.ledTypeOverride >= 0) {
         ledType = static_cast<led_types>(_config.ledTypeOverride);
@@ -211,6 +272,9 @@ bool LedEngine::begin() {
     strand.ledType = ledType;
     strand.brightLimit = 255;
     strand.numPixels = _config.ledCount;
+    strand.fullRefreshInterval = _config.fullRefreshFrames;
+    strand.rmtResolutionHz = _config.rmtResolutionHz;
+    strand.rmtMemBlockSymbols = _config.rmtMemBlockSymbols;
     strand.pixels = nullptr;
     strand._stateVars = nullptr;
 
@@ -219,10 +283,24 @@ bool LedEngine::begin() {
         return false;
     }
 
+#if defined(ARDUINO_ARCH_ESP32)
+    const uint16_t maxFps = getMaxFPS();
+    if (maxFps > 0 && _config.targetFPS > maxFps) {
+        ESP_LOGW("LedEngine", "targetFPS %u exceeds the %u FPS wire limit of %u pixels",
+                 _config.targetFPS, maxFps, _config.ledCount);
+    }
+#endif
+
     _hwBuffer = reinterpret_cast<CRGBW*>(_strand->pixels);
     if (!_renderBuffer) {
         _renderBuffer = new CRGBW[_config.ledCount];
     }
+    if (_config.directPixelMode && !_directBuffers[0]) {
+        CRGBW* frames = new CRGBW[_config.ledCount * 3];
+        for (uint8_t i = 0; i < 3; ++i) {
+            _directBuffers[i] = frames + i * _config.ledCount;
+        }
+    }
     clearLEDs();
 
 #if defined(ARDUINO_ARCH_ESP32)
@@ -271,21 +349,95 @@ void LedEngine::update(uint32_t clockMillis, const LedEngineState& state) {
     }
 
 #if defined(ARDUINO_ARCH_ESP32)
+    bool changed = false;
     if (_stateMutex && xSemaphoreTake(_stateMutex, portMAX_DELAY) == pdTRUE) {
+        changed = _stateDirty || !statesEqual(state, _pendingState);
         _pendingState = state;
-        _pendingClockMillis = clockMillis;
+        _clockOffset = static_cast<int32_t>(clockMillis - millis());
         _stateDirty = true;
         xSemaphoreGive(_stateMutex);
     }
+    // A governed render task may be sleeping at the keep-alive rate.
+    if (changed && _renderTaskHandle) {
+        xTaskNotifyGive(_renderTaskHandle);
+    }
 #else
     _state = state;
     _pendingState = state;
     _stateDirty = true;
-    _pendingClockMillis = clockMillis;
+    _clockOffset = static_cast<int32_t>(clockMillis - millis());
     serviceRenderTick();
 #endif
 }
 
+void LedEngine::syncClock(uint32_t clockMillis) {
+    // A single aligned 32-bit store; the render task tolerates either value
+    _clockOffset = static_cast<int32_t>(clockMillis - millis());
+}
+
+CRGBW* LedEngine::getDirectWriteBuffer() {
+    return _directBuffers[0] ? _directBuffers[_directWrite] : nullptr;
+}
+
+void LedEngine::commitDirectFrame() {
+    if (!_directBuffers[0]) {
+        return;
+    }
+    // Publish the filled buffer and take back whichever one was pending
+    uint8_t previous = _directReady.exchange(_directWrite | kDirectFresh, std::memory_order_acq_rel);
+    _directWrite = previous & 0x3;
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_directMode && _renderTaskHandle) {
+        xTaskNotifyGive(_renderTaskHandle);
+    }
+#endif
+}
+
+void LedEngine::setDirectMode(bool enabled) {
+    _directMode = enabled && _directBuffers[0] != nullptr;
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_renderTaskHandle) {
+        xTaskNotifyGive(_renderTaskHandle);
+    }
+#endif
+}
+
+void LedEngine::markProbe(uint8_t id) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_stateMutex && xSemaphoreTake(_stateMutex, portMAX_DELAY) == pdTRUE) {
+        _pendingProbe = id;
+        xSemaphoreGive(_stateMutex);
+    }
+    if (_renderTaskHandle) {
+        xTaskNotifyGive(_renderTaskHandle);
+    }
+#else
+    _pendingProbe = id;
+#endif
+}
+
+bool LedEngine::takePresentedProbe(uint8_t& id, uint32_t& transmitUs) {
+    if (_presentedProbe.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    // The acquire in the exchange orders the stamp read after it, so the
+    // stamp belongs to the id taken (probes are tens of ms apart)
+    id = _presentedProbe.exchange(0, std::memory_order_acq_rel);
+    if (id == 0) {
+        return false;
+    }
+    transmitUs = _presentedProbeUs;
+    return true;
+}
+
+void LedEngine::renderDirectFrame() {
+    if (_directReady.load(std::memory_order_acquire) & kDirectFresh) {
+        uint8_t previous = _directReady.exchange(_directFront, std::memory_order_acq_rel);
+        _directFront = previous & 0x3;
+    }
+    memcpy(_renderBuffer, _directBuffers[_directFront], sizeof(CRGBW) * _config.ledCount);
+}
+
 void LedEngine::renderTaskTrampoline(void* param) {
 #if defined(ARDUINO_ARCH_ESP32)
     static_cast<LedEngine*>(param)->renderTaskLoop();
@@ -294,13 +446,17 @@ void LedEngine::renderTaskTrampoline(void* param) {
 
 void LedEngine::renderTaskLoop() {
 #if defined(ARDUINO_ARCH_ESP32)
-    const TickType_t frameDelay = pdMS_TO_TICKS(50); // ~20 FPS
     while (true) {
         TickType_t startTick = xTaskGetTickCount();
         serviceRenderTick();
+        TickType_t frameDelay = pdMS_TO_TICKS(_frameIntervalMs);
+        if (frameDelay == 0) {
+            frameDelay = 1;
+        }
         TickType_t elapsed = xTaskGetTickCount() - startTick;
         if (elapsed < frameDelay) {
-            vTaskDelay(frameDelay - elapsed);
+            // update() notifies on state changes so a new look never waits out a keep-alive interval
+            ulTaskNotifyTake(pdTRUE, frameDelay - elapsed);
         }
     }
 #endif
@@ -311,16 +467,15 @@ void LedEngine::serviceRenderTick() {
         return;
     }
 
-    uint32_t clockMillis = millis();
 #if defined(ARDUINO_ARCH_ESP32)
     if (_stateMutex && xSemaphoreTake(_stateMutex, portMAX_DELAY) == pdTRUE) {
         if (_stateDirty) {
             _state = _pendingState;
             _stateDirty = false;
         }
-        if (_pendingClockMillis != 0) {
-            clockMillis = _pendingClockMillis;
-            _pendingClockMillis = 0;
+        if (_pendingProbe) {
+            _renderProbe = _pendingProbe;
+            _pendingProbe = 0;
         }
         xSemaphoreGive(_stateMutex);
     }
@@ -328,10 +483,14 @@ void LedEngine::serviceRenderTick() {
     if (_stateDirty) {
         _state = _pendingState;
         _stateDirty = false;
-        clockMillis = _pendingClockMillis;
-        _pendingClockMillis = 0;
+    }
+    if (_pendingProbe) {
+        _renderProbe = _pendingProbe;
+        _pendingProbe = 0;
     }
 #endif
+    // Frames rendered between update() calls still follow the caller's clock
+    uint32_t clockMillis = millis() + static_cast<uint32_t>(_clockOffset);
 
     if (_frameIntervalMs == 0) {
         _frameIntervalMs = 16;
@@ -342,32 +501,113 @@ void LedEngine::serviceRenderTick() {
         elapsed = 1;
     }
 
-    _animationPhase += static_cast<uint32_t>(_state.animationSpeed) * elapsed;
+    if (_state.tempoSync && _state.beatPeriodUs > 0) {
+        const uint32_t phase = beatLockedPhase(clockMillis);
+        _phaseStep = phase - _animationPhase;
+        _animationPhase = phase;
+        _phaseFraction = 0;
+    } else {
+        // 8.8 speed; the fractional phase carries over so fine speeds don't stall
+        const uint32_t scaledStep = ((static_cast<uint32_t>(_state.animationSpeed) << 8) |
+                                     _state.animationSpeedFine) * elapsed + _phaseFraction;
+        _phaseStep = scaledStep >> 8;
+        _phaseFraction = static_cast<uint8_t>(scaledStep);
+        _animationPhase += _phaseStep;
+    }
     _lastUpdateClock = clockMillis;
 
     if (_strand) {
         _strand->brightLimit = _state.masterBrightness;
+        _strand->brightFine = _state.masterBrightnessFine;
     }
 
-    renderFrame(clockMillis);
+    if (_directMode) {
+        renderDirectFrame();
+    } else {
+        renderFrame(clockMillis);
+    }
     _lastRenderedState = _state;
-    presentFrame();
+    governFrameRate(presentFrame());
 }
 
-void LedEngine::presentFrame() {
-    if (!_strand || !_renderBuffer || !_hwBuffer) {
+// Tempo sync: the top three speed bits pick 8 << n phase steps per beat, so
+// speeds 160-191 run one 256-step cycle per beat. Speed 0 still freezes.
+uint32_t LedEngine::beatLockedPhase(uint32_t clockMillis) const {
+    if (_state.animationSpeed == 0) {
+        return _animationPhase;
+    }
+    const uint64_t phasePerBeat = 8ULL << (_state.animationSpeed >> 5);
+    const int32_t sinceEpochMs = static_cast<int32_t>(clockMillis - _state.beatEpochMs);
+    const int64_t beatsQ16 = (static_cast<int64_t>(_state.beatIndex) << 16) +
+                             (static_cast<int64_t>(sinceEpochMs) * 1000 * 65536) / _state.beatPeriodUs;
+    return static_cast<uint32_t>((beatsQ16 * static_cast<int64_t>(phasePerBeat)) >> 16);
+}
+
+// Phase advances animationSpeed/256 LEDs (or hue steps) per millisecond. Moving
+// content runs at least at targetFPS and faster when it would otherwise skip
+// more than one LED per frame, up to the wire limit; static output idles at minFPS.
+void LedEngine::governFrameRate(bool contentChanged) {
+    const uint16_t targetFps = _config.targetFPS == 0 ? 60 : _config.targetFPS;
+    if (!_config.adaptiveFPS) {
+        _frameIntervalMs = 1000 / targetFps;
         return;
     }
 
+    // A slow phase-driven mode repeats frames while the 8.8 phase builds up
+    // to the next LED; it is still moving and must not drop to minFPS. The
+    // phase advances in every mode, so elsewhere it says nothing.
+    const bool phaseMoving = !_directMode && isPhaseDriven(_state.mode) &&
+        (_phaseStep != 0 || _state.animationSpeed != 0 || _state.animationSpeedFine != 0);
+    _staticFrames = (contentChanged || phaseMoving)
+        ? 0
+        : static_cast<uint16_t>(std::min<uint32_t>(_staticFrames + 1, UINT16_MAX));
+
+    uint32_t ceiling = getMaxFPS();
+    if (_config.maxFPS > 0 && (ceiling == 0 || _config.maxFPS < ceiling)) {
+        ceiling = _config.maxFPS;
+    }
+    if (ceiling == 0) {
+        ceiling = targetFps;
+    }
+
+    uint32_t fps = targetFps;
+    if (_staticFrames >= kStaticFramesBeforeIdle) {
+        fps = _config.minFPS == 0 ? 1 : _config.minFPS;
+    } else {
+        if (!_directMode && isPhaseDriven(_state.mode)) {
+            const uint32_t stepsPerSecond = (static_cast<uint32_t>(_state.animationSpeed) * 1000) >> 8;
+            fps = std::max<uint32_t>(fps, stepsPerSecond);
+        }
+        fps = std::min(fps, std::max<uint32_t>(ceiling, _config.minFPS));
+    }
+
+    _frameIntervalMs = std::max<uint32_t>(1000 / std::max<uint32_t>(fps, 1), 1);
+}
+
+bool LedEngine::presentFrame() {
+    if (!_strand || !_renderBuffer || !_hwBuffer) {
+        return false;
+    }
+
 #if defined(ARDUINO_ARCH_ESP32)
     if (_bufferMutex) {
         if (xSemaphoreTake(_bufferMutex, portMAX_DELAY) != pdTRUE) {
-            return;
+            return false;
         }
     }
 #endif
 
-    memcpy(_hwBuffer, _renderBuffer, sizeof(CRGBW) * _config.ledCount);
+    const size_t frameBytes = sizeof(CRGBW) * _config.ledCount;
+    const int brightness = (_strand->brightLimit << 8) | _strand->brightFine;
+    const bool changed = _presentedBrightness != brightness ||
+                         memcmp(_hwBuffer, _renderBuffer, frameBytes) != 0;
+    _presentedBrightness = brightness;
+    memcpy(_hwBuffer, _renderBuffer, frameBytes);
+    if (_renderProbe) {
+        _presentedProbeUs = micros();
+        _presentedProbe.store(_renderProbe, std::memory_order_release);
+        _renderProbe = 0;
+    }
     LibStrip::updatePixels(_strand);
 
 #if defined(ARDUINO_ARCH_ESP32)
@@ -377,6 +617,7 @@ void LedEngine::presentFrame() {
 #endif
 
     calculateFPS();
+    return changed;
 }
 
 void LedEngine::renderFrame(uint32_t clockMillis) {
@@ -449,6 +690,38 @@ const CRGB* LedEngine::getPreviewPixels() const {
     return _previewBuffer;
 }
 
+bool LedEngine::getStripTelemetry(strandTelemetry_t& telemetry) const {
+    if (!_strand) {
+        return false;
+    }
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_bufferMutex) {
+        if (xSemaphoreTake(_bufferMutex, portMAX_DELAY) != pdTRUE) {
+            return false;
+        }
+    }
+#endif
+
+    const bool ok = LibStrip::getTelemetry(_strand, &telemetry) == 0;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (_bufferMutex) {
+        xSemaphoreGive(_bufferMutex);
+    }
+#endif
+
+    return ok;
+}
+
+uint16_t LedEngine::getMaxFPS() const {
+    strandTelemetry_t telemetry;
+    if (!_strand || LibStrip::getTelemetry(_strand, &telemetry) != 0) {
+        return 0;
+    }
+    return telemetry.maxFps;
+}
+
 void LedEngine::renderSolid() {
     for (uint16_t i = 0; i < _config.ledCount; ++i) {
         setPixelRGBW(i, _state.colorA);
@@ -801,8 +1074,10 @@ void LedEngine::calculateFPS() {
 
 bool LedEngine::statesEqual(const LedEngineState& a, const LedEngineState& b) const {
     if (a.masterBrightness != b.masterBrightness) return false;
+    if (a.masterBrightnessFine != b.masterBrightnessFine) return false;
     if (a.mode != b.mode) return false;
     if (a.animationSpeed != b.animationSpeed) return false;
+    if (a.animationSpeedFine != b.animationSpeedFine) return false;
     if (a.animationCtrl != b.animationCtrl) return false;
     if (a.strobeRate != b.strobeRate) return false;
     if (a.blendMode != b.blendMode) return false;
@@ -815,6 +1090,10 @@ bool LedEngine::statesEqual(const LedEngineState& a, const LedEngineState& b) co
 
     if (!colorsEqual(a.colorA, b.colorA)) return false;
     if (!colorsEqual(a.colorB, b.colorB)) return false;
+    if (a.tempoSync != b.tempoSync) return false;
+    if (a.beatPeriodUs != b.beatPeriodUs) return false;
+    if (a.beatEpochMs != b.beatEpochMs) return false;
+    if (a.beatIndex != b.beatIndex) return false;
     return true;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <atomic>
 
 #if defined(ARDUINO_ARCH_ESP32)
 #include <freertos/FreeRTOS.h>
@@ -28,6 +29,8 @@ struct ColorRGBW {
         : r(red), g(green), b(blue), w(white) {}
 
     void fromHSV(uint8_t hue, uint8_t sat, uint8_t val, uint8_t white = 0);
+    // Same with a 16-bit hue (full circle = 65536) for slow, step-free fades
+    void fromHSV16(uint16_t hue, uint8_t sat, uint8_t val, uint8_t white = 0);
     CRGB toCRGB() const;
 };
 
@@ -86,12 +89,24 @@ struct LedEngineConfig {
     bool enableRGBW = true;
     uint8_t rmtChannel = 0;
     int ledTypeOverride = -1; // Use values from led_types or -1 for auto
+    uint16_t fullRefreshFrames = 60; // Unchanged tail pixels are resent this often, 0 = every frame
+    uint32_t rmtResolutionHz = 0;    // 0 = derived from the LED timings
+    uint16_t rmtMemBlockSymbols = 0; // 0 = fair share of the RMT memory
+    uint8_t rmtStrandsPlanned = 0;   // Engines sharing the RMT peripheral, 0 = unknown
+    bool adaptiveFPS = true;         // Let the frame-rate governor move away from targetFPS
+    uint8_t minFPS = 2;              // Keep-alive rate while the output is static
+    uint16_t maxFPS = 0;             // Ceiling for fast motion, 0 = wire-time limit
+    bool directPixelMode = false;    // Allocate triple buffers for streamed pixel frames
 };
 
+// The *Fine fields are fractional LSBs from 16-bit sources (DMX fine
+// channels): the effective value is coarse + fine / 256.
 struct LedEngineState {
     uint8_t masterBrightness = 0;
+    uint8_t masterBrightnessFine = 0;
     AnimationMode mode = ANIM_SOLID;
     uint8_t animationSpeed = 0;
+    uint8_t animationSpeedFine = 0;
     uint8_t animationCtrl = 0;
     uint8_t strobeRate = 0;
     uint8_t blendMode = 0;
@@ -99,6 +114,13 @@ struct LedEngineState {
     DirectionMode direction = DIR_FORWARD;
     ColorRGBW colorA;
     ColorRGBW colorB;
+    // Beat grid (see LeslieProtocol::TempoInfo). With tempoSync the phase is
+    // a function of the beat position, so every node shows the same frame
+    // and animationSpeed picks a beat division instead of a rate.
+    bool tempoSync = false;
+    uint32_t beatPeriodUs = 0;
+    uint32_t beatEpochMs = 0;
+    uint32_t beatIndex = 0;
 };
 
 class LedEngine {
@@ -107,13 +129,37 @@ public:
     ~LedEngine();
 
     bool begin();
+    // clockMillis also re-anchors the render clock (e.g. meshMillis()), so
+    // the render task keeps animations in phase between updates.
     void update(uint32_t clockMillis, const LedEngineState& state);
+    // Re-anchors the render clock without touching the state
+    void syncClock(uint32_t clockMillis);
     void show();
 
+    // Direct pixel mode (config.directPixelMode): a single producer fills
+    // getDirectWriteBuffer() and publishes it with commitDirectFrame(); the
+    // render task shows the newest committed frame instead of the
+    // parametric animation while direct mode is enabled. Lock-free triple
+    // buffer, so the producer may run in the ESP-NOW receive callback.
+    CRGBW* getDirectWriteBuffer();
+    void commitDirectFrame();
+    void setDirectMode(bool enabled);
+    bool isDirectMode() const { return _directMode; }
+
+    // Latency probes: the first frame rendered from state handed over after
+    // markProbe() stamps micros() just before its strip transmit starts.
+    // takePresentedProbe() returns that stamp once.
+    void markProbe(uint8_t id);
+    bool takePresentedProbe(uint8_t& id, uint32_t& transmitUs);
+
     uint16_t getLedCount() const { return _config.ledCount; }
     uint8_t getFPS() const { return _fps; }
+    uint16_t getGovernedFPS() const { return _frameIntervalMs == 0 ? 0 : 1000 / _frameIntervalMs; }
+    uint32_t getPhaseStep() const { return _phaseStep; }
     const LedEngineState& getState() const { return _state; }
     const CRGB* getPreviewPixels() const;
+    bool getStripTelemetry(strandTelemetry_t& telemetry) const;
+    uint16_t getMaxFPS() const;
 
 private:
     LedEngineConfig _config;
@@ -128,6 +174,10 @@ private:
     uint32_t _animationPhase;
     uint32_t _lastUpdateClock;
     uint32_t _frameIntervalMs;
+    uint32_t _phaseStep;
+    uint8_t _phaseFraction;  // Sub-unit phase carried between frames
+    uint16_t _staticFrames;
+    int _presentedBrightness;
     uint32_t _frameCount;
     uint32_t _fpsTimer;
     uint8_t _fps;
@@ -136,12 +186,27 @@ private:
     SemaphoreHandle_t _bufferMutex;
     LedEngineState _pendingState;
     bool _stateDirty;
-    uint32_t _pendingClockMillis;
+    volatile int32_t _clockOffset;  // Caller clock minus millis()
+
+    static constexpr uint8_t kDirectFresh = 0x4;
+    CRGBW* _directBuffers[3];
+    uint8_t _directWrite;               // Producer-owned
+    uint8_t _directFront;               // Render-task-owned
+    std::atomic<uint8_t> _directReady;  // Ready index | kDirectFresh
+    volatile bool _directMode;
+
+    uint8_t _pendingProbe;                  // Guarded by _stateMutex
+    uint8_t _renderProbe;                   // Render-task-owned
+    volatile uint32_t _presentedProbeUs;
+    std::atomic<uint8_t> _presentedProbe;
 
     static void renderTaskTrampoline(void* param);
     void renderTaskLoop();
     void serviceRenderTick();
-    void presentFrame();
+    bool presentFrame();
+    void renderDirectFrame();
+    void governFrameRate(bool contentChanged);
+    uint32_t beatLockedPhase(uint32_t clockMillis) const;
 
     void renderFrame(uint32_t clockMillis);
     void renderSolid();
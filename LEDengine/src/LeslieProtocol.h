@@ -0,0 +1,174 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Compact LeslieLEDs packets sent over the same ESP-NOW link as ESPNowDMX.
+// A receiver only needs its 32-channel zone, so this replaces the 512-byte
+// universe for the common case; full-universe DMX stays as a compatibility mode.
+namespace LeslieProtocol {
+
+constexpr uint8_t kMagic0 = 'L';
+constexpr uint8_t kMagic1 = 'Z';
+constexpr uint8_t kVersion = 6;
+// 16 coarse channels followed by their 16 fine (LSB) channels
+constexpr uint8_t kStateChannels = 32;
+constexpr uint8_t kFineChannelOffset = 16;
+constexpr uint16_t kUniverseSize = 512;
+// Zones are addressed like DMX fixtures: 1-based start address of the
+// 32-channel block, so one universe holds up to 16 independent looks.
+constexpr uint16_t kMaxStartAddress = kUniverseSize - kStateChannels + 1;
+
+enum PacketType : uint8_t {
+    PACKET_STATE = 1,
+    PACKET_PIXELS = 2,
+    PACKET_SYNC = 3
+};
+
+// Direct pixel streams are laid out like consecutive DMX universes starting
+// at a base universe; each universe travels as four 128-byte chunks so a
+// packet stays well inside the 250-byte ESP-NOW payload.
+constexpr uint16_t kPixelChunkBytes = 128;
+constexpr uint8_t kChunksPerUniverse = kUniverseSize / kPixelChunkBytes;
+constexpr uint8_t kMaxPixelChunks = 64;  // 8 KB of encoded stream per frame
+
+// Pixel frames are PixelCodec streams: keyframes stand alone, delta frames
+// XOR against the frame named by baseFrameId. A receiver that missed the
+// base waits for the next keyframe.
+constexpr uint8_t kFlagKeyframe = 0x01;
+// State packets: lock the animation phase to the beat grid in TempoInfo
+constexpr uint8_t kFlagTempoSync = 0x02;
+
+enum PixelFormat : uint8_t {
+    PIXEL_RGB = 3,
+    PIXEL_RGBW = 4
+};
+
+struct __attribute__((packed)) PacketHeader {
+    uint8_t magic[2];
+    uint8_t version;
+    uint8_t type;
+    uint8_t universe;
+    uint8_t flags;
+    uint16_t sequence;
+};
+
+// Beat grid recovered from the controller's MIDI clock: beat number
+// beatIndex (counted from MIDI Start) fell on mesh time beatEpochMs. Any
+// node can extrapolate the beat position from mesh time alone.
+// beatPeriodUs == 0 means no clock.
+struct __attribute__((packed)) TempoInfo {
+    uint32_t beatPeriodUs;
+    uint32_t beatEpochMs;
+    uint32_t beatIndex;
+};
+
+// Latency probe: the controller stamps a probe CC as it passes each of its
+// hops, in mesh-clock microseconds (low 32 bits, so only differences are
+// meaningful). The latest probe rides along until the next one; id 0 = none.
+struct __attribute__((packed)) ProbeInfo {
+    uint8_t id;
+    uint32_t midiReadUs;
+    uint32_t stateAppliedUs;
+    uint32_t sentUs;
+};
+
+// meshTimeMs is the sender's meshMillis() when the state was captured;
+// receivers play it out at meshTimeMs + their playout delay so every node
+// switches on the same mesh tick regardless of per-node air latency.
+struct __attribute__((packed)) StatePacket {
+    PacketHeader header;
+    uint32_t meshTimeMs;
+    uint16_t startAddress;
+    TempoInfo tempo;
+    ProbeInfo probe;
+    uint8_t channels[kStateChannels];
+};
+
+static_assert(sizeof(StatePacket) == 71, "StatePacket layout changed");
+
+constexpr bool isValidStartAddress(uint16_t address) {
+    return address >= 1 && address <= kMaxStartAddress;
+}
+
+// One chunk of an encoded pixel frame; header.universe is the stream
+// universe the chunk belongs to and header.flags carries kFlagKeyframe.
+// Byte offset in the encoded stream is
+// (universe - base) * kUniverseSize + chunk * kPixelChunkBytes.
+struct __attribute__((packed)) PixelPacket {
+    PacketHeader header;
+    uint8_t frameId;
+    uint8_t baseFrameId;  // Delta reference, equals frameId on keyframes
+    uint8_t chunk;
+    uint8_t length;
+    uint8_t format;  // PixelFormat
+    uint8_t data[kPixelChunkBytes];
+};
+
+// Sent after the last chunk: the receiver shows frameId only if every chunk
+// covering pixelCount * format bytes arrived.
+struct __attribute__((packed)) SyncPacket {
+    PacketHeader header;
+    uint8_t frameId;
+    uint8_t format;
+    uint16_t pixelCount;
+    uint16_t encodedBytes;
+    uint32_t meshTimeMs;
+};
+
+static_assert(sizeof(PixelPacket) == 141, "PixelPacket layout changed");
+static_assert(sizeof(SyncPacket) == 18, "SyncPacket layout changed");
+
+inline void initHeader(PacketHeader& header, PacketType type, uint8_t universe, uint16_t sequence) {
+    header.magic[0] = kMagic0;
+    header.magic[1] = kMagic1;
+    header.version = kVersion;
+    header.type = type;
+    header.universe = universe;
+    header.flags = 0;
+    header.sequence = sequence;
+}
+
+// Cheap first-byte check so foreign ESP-NOW traffic is rejected before any copy.
+inline bool isLesliePacket(const uint8_t* data, int len) {
+    return data && len >= static_cast<int>(sizeof(PacketHeader)) &&
+           data[0] == kMagic0 && data[1] == kMagic1 && data[2] == kVersion;
+}
+
+inline bool decodeState(const uint8_t* data, int len, StatePacket& out) {
+    if (!isLesliePacket(data, len) || len < static_cast<int>(sizeof(StatePacket)) ||
+        data[3] != PACKET_STATE) {
+        return false;
+    }
+    memcpy(&out, data, sizeof(StatePacket));
+    return true;
+}
+
+// Pixel chunks are decoded in place (no copy) from the receive buffer
+inline const PixelPacket* asPixels(const uint8_t* data, int len) {
+    constexpr int kPixelHeaderBytes = static_cast<int>(sizeof(PixelPacket) - kPixelChunkBytes);
+    if (!isLesliePacket(data, len) || data[3] != PACKET_PIXELS || len < kPixelHeaderBytes) {
+        return nullptr;
+    }
+    const PixelPacket* packet = reinterpret_cast<const PixelPacket*>(data);
+    if (packet->length > kPixelChunkBytes || len < kPixelHeaderBytes + packet->length ||
+        packet->chunk >= kChunksPerUniverse ||
+        (packet->format != PIXEL_RGB && packet->format != PIXEL_RGBW)) {
+        return nullptr;
+    }
+    return packet;
+}
+
+inline const SyncPacket* asSync(const uint8_t* data, int len) {
+    if (!isLesliePacket(data, len) || data[3] != PACKET_SYNC ||
+        len < static_cast<int>(sizeof(SyncPacket))) {
+        return nullptr;
+    }
+    const SyncPacket* packet = reinterpret_cast<const SyncPacket*>(data);
+    if (packet->format != PIXEL_RGB && packet->format != PIXEL_RGBW) {
+        return nullptr;
+    }
+    return packet;
+}
+
+} // namespace LeslieProtocol
@@ -0,0 +1,110 @@
+#include "PixelCodec.h"
+
+#include <string.h>
+
+namespace LedEngineLib {
+
+namespace {
+
+constexpr size_t kMaxRun = 128;
+
+inline uint8_t codedByte(const uint8_t* current, const uint8_t* previous, size_t i) {
+    return previous ? static_cast<uint8_t>(current[i] ^ previous[i]) : current[i];
+}
+
+}
+
+size_t PixelEncoder::encode(const uint8_t* current, const uint8_t* previous, size_t len,
+                            uint8_t* out, size_t capacity) {
+    size_t o = 0;
+    size_t i = 0;
+    while (i < len) {
+        // Zero run: unchanged bytes (delta) or dark channels (keyframe).
+        // A single zero between literals is cheaper kept in the literal.
+        size_t zeros = 0;
+        while (i + zeros < len && zeros < kMaxRun && codedByte(current, previous, i + zeros) == 0) {
+            ++zeros;
+        }
+        if (zeros >= 2 || (zeros == 1 && i + 1 == len)) {
+            if (o + 1 > capacity) {
+                return 0;
+            }
+            out[o++] = static_cast<uint8_t>(0x80 | (zeros - 1));
+            i += zeros;
+            continue;
+        }
+
+        // Literal run until the next pair of zeros
+        size_t start = i;
+        size_t count = 0;
+        while (i < len && count < kMaxRun) {
+            if (codedByte(current, previous, i) == 0 && i + 1 < len &&
+                codedByte(current, previous, i + 1) == 0) {
+                break;
+            }
+            ++i;
+            ++count;
+        }
+        if (o + 1 + count > capacity) {
+            return 0;
+        }
+        out[o++] = static_cast<uint8_t>(count - 1);
+        for (size_t k = 0; k < count; ++k) {
+            out[o++] = codedByte(current, previous, start + k);
+        }
+    }
+    return o;
+}
+
+PixelDecoder::PixelDecoder()
+    : _reference(nullptr)
+    , _referenceLen(0)
+    , _pos(0)
+    , _streamLimit(0)
+    , _literalRemaining(0)
+    , _delta(false) {
+}
+
+void PixelDecoder::begin(uint8_t* reference, size_t referenceLen, bool delta, size_t streamLimit) {
+    _reference = reference;
+    _referenceLen = reference ? referenceLen : 0;
+    _pos = 0;
+    _streamLimit = streamLimit;
+    _literalRemaining = 0;
+    _delta = delta;
+}
+
+bool PixelDecoder::feed(const uint8_t* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        if (_literalRemaining > 0) {
+            size_t take = len - i < _literalRemaining ? len - i : _literalRemaining;
+            for (size_t k = 0; k < take; ++k, ++_pos) {
+                if (_pos < _referenceLen) {
+                    _reference[_pos] = _delta ? static_cast<uint8_t>(_reference[_pos] ^ data[i + k]) : data[i + k];
+                }
+            }
+            i += take;
+            _literalRemaining -= take;
+            continue;
+        }
+
+        uint8_t token = data[i++];
+        size_t run = (token & 0x7F) + 1;
+        if (_pos + run > _streamLimit) {
+            return false;
+        }
+        if (token & 0x80) {
+            if (!_delta && _pos < _referenceLen) {
+                size_t n = _referenceLen - _pos < run ? _referenceLen - _pos : run;
+                memset(_reference + _pos, 0, n);
+            }
+            _pos += run;
+        } else {
+            _literalRemaining = static_cast<uint8_t>(run);
+        }
+    }
+    return true;
+}
+
+} // namespace LedEngineLib
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace LedEngineLib {
+
+// Byte-oriented pixel frame codec for the direct pixel stream.
+//
+// A frame is a run-length token stream over the raw channel bytes:
+//   0x00-0x7F  literal run, (token + 1) bytes follow
+//   0x80-0xFF  zero run of (token & 0x7F) + 1 bytes, no payload
+// Keyframes code the bytes themselves (dark spans become zero runs). Delta
+// frames code current XOR previous, so unchanged spans collapse to zero
+// runs and only the changed bytes travel.
+class PixelEncoder {
+public:
+    // Worst-case encoded size for len raw bytes
+    static constexpr size_t maxEncodedSize(size_t len) { return len + (len + 127) / 128; }
+
+    // previous == nullptr encodes a keyframe. Returns the encoded size, or 0
+    // if it would exceed capacity.
+    static size_t encode(const uint8_t* current, const uint8_t* previous, size_t len,
+                         uint8_t* out, size_t capacity);
+};
+
+// Incremental decoder: feed() the encoded stream in arbitrary pieces (e.g.
+// one radio chunk at a time) and it updates the reference frame in place.
+// Holds no buffers of its own. Bytes beyond the reference length are
+// consumed and discarded, so a receiver with a shorter strip stays in step.
+class PixelDecoder {
+public:
+    PixelDecoder();
+
+    // streamLimit bounds the decoded length; longer streams are malformed
+    void begin(uint8_t* reference, size_t referenceLen, bool delta, size_t streamLimit = SIZE_MAX);
+    // Returns false on a malformed stream; the reference is then undefined
+    bool feed(const uint8_t* data, size_t len);
+
+    // Raw bytes produced so far, and whether a literal run is still open
+    size_t decodedBytes() const { return _pos; }
+    bool atTokenBoundary() const { return _literalRemaining == 0; }
+
+private:
+    uint8_t* _reference;
+    size_t _referenceLen;
+    size_t _pos;
+    size_t _streamLimit;
+    uint8_t _literalRemaining;
+    bool _delta;
+};
+
+} // namespace LedEngineLib
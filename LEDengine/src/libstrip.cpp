@@ -18,6 +18,8 @@ extern "C" {
 #include "esp_check.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "soc/soc_caps.h"
 
 namespace {
 
@@ -63,6 +65,7 @@ struct le_led_strip_config_t {
         uint32_t invert_out : 1;
     } flags;
     le_led_strip_encoder_timings_t timings;
+    uint32_t full_refresh_interval;
 };
 
 struct le_led_strip_rmt_config_t {
@@ -99,6 +102,14 @@ struct LedStripRmtObj {
     le_led_color_component_format_t component_fmt;
     uint8_t* pixel_buf;
     bool pixel_buf_allocated_internally;
+    // Pixels latch their last value, so only the prefix up to the highest
+    // changed index has to go out on the wire.
+    uint32_t dirty_len;
+    uint32_t full_refresh_interval;
+    uint32_t frames_since_full;
+    bool force_full;
+    uint32_t last_tx_pixels;
+    uint32_t last_tx_us;
 };
 
 inline LedStripRmtObj* toRmt(le_led_strip_t* strip) {
@@ -115,13 +126,22 @@ static esp_err_t led_strip_rmt_set_pixel(le_led_strip_t* strip, uint32_t index,
     uint32_t start = index * rmt_strip->bytes_per_pixel;
     uint8_t* pixel_buf = rmt_strip->pixel_buf;
 
-    pixel_buf[start + component_fmt.format.r_pos] = red & 0xFF;
-    pixel_buf[start + component_fmt.format.g_pos] = green & 0xFF;
-    pixel_buf[start + component_fmt.format.b_pos] = blue & 0xFF;
+    uint8_t changed = 0;
+    auto store = [&](uint32_t pos, uint32_t value) {
+        changed |= pixel_buf[start + pos] ^ static_cast<uint8_t>(value);
+        pixel_buf[start + pos] = value & 0xFF;
+    };
+
+    store(component_fmt.format.r_pos, red);
+    store(component_fmt.format.g_pos, green);
+    store(component_fmt.format.b_pos, blue);
     if (component_fmt.format.num_components > 3) {
-        pixel_buf[start + component_fmt.format.w_pos] = 0;
+        store(component_fmt.format.w_pos, 0);
     }
 
+    if (changed && index >= rmt_strip->dirty_len) {
+        rmt_strip->dirty_len = index + 1;
+    }
     return ESP_OK;
 }
 
@@ -134,21 +154,50 @@ static esp_err_t led_strip_rmt_set_pixel_rgbw(le_led_strip_t* strip, uint32_t in
     uint32_t start = index * rmt_strip->bytes_per_pixel;
     uint8_t* pixel_buf = rmt_strip->pixel_buf;
 
-    pixel_buf[start + component_fmt.format.r_pos] = red & 0xFF;
-    pixel_buf[start + component_fmt.format.g_pos] = green & 0xFF;
-    pixel_buf[start + component_fmt.format.b_pos] = blue & 0xFF;
-    pixel_buf[start + component_fmt.format.w_pos] = white & 0xFF;
+    uint8_t changed = 0;
+    auto store = [&](uint32_t pos, uint32_t value) {
+        changed |= pixel_buf[start + pos] ^ static_cast<uint8_t>(value);
+        pixel_buf[start + pos] = value & 0xFF;
+    };
+
+    store(component_fmt.format.r_pos, red);
+    store(component_fmt.format.g_pos, green);
+    store(component_fmt.format.b_pos, blue);
+    store(component_fmt.format.w_pos, white);
 
+    if (changed && index >= rmt_strip->dirty_len) {
+        rmt_strip->dirty_len = index + 1;
+    }
     return ESP_OK;
 }
 
 static esp_err_t led_strip_rmt_refresh(le_led_strip_t* strip) {
     auto* rmt_strip = toRmt(strip);
+
+    uint32_t tx_len = rmt_strip->dirty_len;
+    rmt_strip->frames_since_full++;
+    if (rmt_strip->force_full || rmt_strip->full_refresh_interval == 0 ||
+        rmt_strip->frames_since_full >= rmt_strip->full_refresh_interval) {
+        tx_len = rmt_strip->strip_len;
+    }
+    rmt_strip->last_tx_pixels = tx_len;
+    rmt_strip->last_tx_us = 0;
+    if (tx_len == 0) {
+        return ESP_OK;
+    }
+    if (tx_len == rmt_strip->strip_len) {
+        rmt_strip->frames_since_full = 0;
+        rmt_strip->force_full = false;
+    }
+    rmt_strip->dirty_len = 0;
+
     ESP_RETURN_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), kTag, "enable channel failed");
+    const int64_t tx_start = esp_timer_get_time();
     ESP_RETURN_ON_ERROR(rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, rmt_strip->pixel_buf,
-                                     rmt_strip->strip_len * rmt_strip->bytes_per_pixel, &rmt_strip->tx_conf), kTag,
+                                     tx_len * rmt_strip->bytes_per_pixel, &rmt_strip->tx_conf), kTag,
                         "transmit failed");
     ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), kTag, "wait done failed");
+    rmt_strip->last_tx_us = static_cast<uint32_t>(esp_timer_get_time() - tx_start);
     ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), kTag, "disable channel failed");
     return ESP_OK;
 }
@@ -156,6 +205,7 @@ static esp_err_t led_strip_rmt_refresh(le_led_strip_t* strip) {
 static esp_err_t led_strip_rmt_clear(le_led_strip_t* strip) {
     auto* rmt_strip = toRmt(strip);
     memset(rmt_strip->pixel_buf, 0, rmt_strip->strip_len * rmt_strip->bytes_per_pixel);
+    rmt_strip->force_full = true;
     return led_strip_rmt_refresh(strip);
 }
 
@@ -368,7 +418,8 @@ esp_err_t le_rmt_new_led_strip_encoder_with_timings(const le_led_strip_encoder_c
         return err;
     }
 
-    uint32_t reset_ticks = static_cast<uint32_t>((static_cast<uint64_t>(config->resolution) * config->timings.reset) / 1'000'000'000ULL);
+    // Reset is given in microseconds and split over both halves of the symbol.
+    uint32_t reset_ticks = static_cast<uint32_t>((static_cast<uint64_t>(config->resolution) * config->timings.reset) / 1'000'000ULL / 2);
     if (reset_ticks == 0) {
         reset_ticks = 1;
     }
@@ -473,6 +524,12 @@ esp_err_t le_led_strip_new_rmt_device(const le_led_strip_config_t* led_config,
     rmt_strip->component_fmt = component_fmt;
     rmt_strip->bytes_per_pixel = bytes_per_pixel;
     rmt_strip->strip_len = led_config->max_leds;
+    rmt_strip->dirty_len = 0;
+    rmt_strip->full_refresh_interval = led_config->full_refresh_interval;
+    rmt_strip->frames_since_full = 0;
+    rmt_strip->force_full = true;
+    rmt_strip->last_tx_pixels = 0;
+    rmt_strip->last_tx_us = 0;
     rmt_strip->tx_conf = {};
     rmt_strip->tx_conf.loop_count = 0;
     rmt_strip->base.set_pixel = led_strip_rmt_set_pixel;
@@ -526,32 +583,228 @@ const ledParams_t kLedParams[] = {
     {3, S_GRB, 560, 480, 280, 640, 48000},   // LED_TM1934
 };
 
+constexpr int kLedTypeCount = static_cast<int>(sizeof(kLedParams) / sizeof(kLedParams[0]));
+
+// RMT memory is carved into one block per TX channel; a channel that takes
+// several blocks borrows them from its neighbours, so blocks bound strands too.
+constexpr size_t kRmtBlockSymbols = kLedStripRmtDefaultMemSymbols;
+constexpr int kRmtTxBlocks = SOC_RMT_TX_CANDIDATES_PER_GROUP;
+constexpr int kRmtMaxBlocksPerStrand = 4;
+constexpr uint32_t kRmtResolutions[] = {10'000'000, 20'000'000, 40'000'000};
+constexpr uint32_t kRmtMaxTimingErrorNs = 25;
+
+int g_rmtBlocksUsed = 0;
+int g_rmtStrandsPlanned = 0;
+
 struct DigitalLedsState {
     le_led_strip_handle_t stripHandle = nullptr;
     le_led_color_component_format_t colorFormat = {};
     uint8_t bytesPerPixel = 3;
     bool hasWhite = false;
+    uint32_t resolutionHz = 0;
+    int memBlocks = 0;
+    uint32_t bitPeriodNs = 0;
+    uint32_t resetUs = 0;
+    int64_t windowStartUs = 0;
+    uint32_t windowBusyUs = 0;
+    strandTelemetry_t telemetry;
 };
 
+bool validLedType(int ledType) {
+    return ledType >= 0 && ledType < kLedTypeCount;
+}
+
+// Worst-case bit timing error once durations are truncated to ticks, the same
+// way le_rmt_new_led_strip_encoder_with_timings() converts them.
+uint32_t timingErrorNs(const ledParams_t& params, uint32_t resolutionHz) {
+    uint32_t worst = 0;
+    for (uint32_t ns : {params.T0H, params.T0L, params.T1H, params.T1L}) {
+        const uint64_t ticks = (static_cast<uint64_t>(ns) * resolutionHz) / 1'000'000'000ULL;
+        const uint32_t actual = static_cast<uint32_t>((ticks * 1'000'000'000ULL) / resolutionHz);
+        worst = std::max(worst, ns - actual);
+    }
+    return worst;
+}
+
+// Lowest tick rate that reproduces the datasheet timings closely enough.
+// RGBW parts start at 20 MHz, which is what they were validated with.
+uint32_t autoResolution(const ledParams_t& params) {
+    const uint32_t floorHz = params.bytesPerPixel == 4 ? 20'000'000 : 10'000'000;
+    uint32_t best = 0;
+    uint32_t bestError = UINT32_MAX;
+    for (uint32_t hz : kRmtResolutions) {
+        if (hz < floorHz) {
+            continue;
+        }
+        const uint32_t error = timingErrorNs(params, hz);
+        if (error <= kRmtMaxTimingErrorNs) {
+            return hz;
+        }
+        if (error < bestError) {
+            best = hz;
+            bestError = error;
+        }
+    }
+    return best;
+}
+
+int baselineBlocks(const ledParams_t& params) {
+    return params.bytesPerPixel == 4 ? 2 : 1;
+}
+
+// Slowest bit as it actually goes out, i.e. after tick truncation.
+uint32_t wireBitPeriodNs(const le_led_strip_encoder_timings_t& timings, uint32_t resolutionHz) {
+    auto onWire = [resolutionHz](uint32_t ns) -> uint32_t {
+        const uint64_t ticks = (static_cast<uint64_t>(ns) * resolutionHz) / 1'000'000'000ULL;
+        return static_cast<uint32_t>((ticks * 1'000'000'000ULL) / resolutionHz);
+    };
+    return std::max(onWire(timings.t0h) + onWire(timings.t0l), onWire(timings.t1h) + onWire(timings.t1l));
+}
+
+uint32_t wireTimeUs(const DigitalLedsState& state, uint32_t pixels) {
+    const uint64_t bits = static_cast<uint64_t>(pixels) * state.bytesPerPixel * 8;
+    return static_cast<uint32_t>((bits * state.bitPeriodNs) / 1000ULL) + state.resetUs;
+}
+
+void recordTransmit(DigitalLedsState& state, uint32_t numPixels) {
+    const auto* rmt_strip = toRmt(state.stripHandle);
+    strandTelemetry_t& t = state.telemetry;
+
+    const int64_t now = esp_timer_get_time();
+    if (now - state.windowStartUs >= 1'000'000) {
+        const uint64_t span = static_cast<uint64_t>(now - state.windowStartUs);
+        t.linkUtilizationPct = static_cast<uint8_t>(std::min<uint64_t>((state.windowBusyUs * 100ULL) / span, 100));
+        state.windowStartUs = now;
+        state.windowBusyUs = 0;
+    }
+
+    if (rmt_strip->last_tx_pixels == 0) {
+        t.skippedFrames++;
+        return;
+    }
+
+    t.frames++;
+    if (rmt_strip->last_tx_pixels < numPixels) {
+        t.partialFrames++;
+    }
+    t.lastPixelsSent = rmt_strip->last_tx_pixels;
+    t.lastTxUs = rmt_strip->last_tx_us;
+    t.avgTxUs = t.avgTxUs == 0 ? t.lastTxUs : (t.avgTxUs * 7 + t.lastTxUs) / 8;
+    t.maxTxUs = std::max(t.maxTxUs, t.lastTxUs);
+    t.lastWireUs = wireTimeUs(state, t.lastPixelsSent);
+    t.txEfficiencyPct = t.lastTxUs == 0 ? 100 : static_cast<uint8_t>(std::min<uint32_t>((t.lastWireUs * 100) / t.lastTxUs, 100));
+    state.windowBusyUs += t.lastTxUs;
+}
+
+int blocksForSymbols(int symbols) {
+    return static_cast<int>((static_cast<size_t>(symbols) + kRmtBlockSymbols - 1) / kRmtBlockSymbols);
+}
+
 } // namespace
 
 int LibStrip::init() {
     return 0;
 }
 
+void LibStrip::reserveStrands(int count) {
+    g_rmtStrandsPlanned = std::max(g_rmtStrandsPlanned, std::min(count, kMaxStrands));
+}
+
+int LibStrip::autoTuneRmt(strand_t* strands, int count) {
+    if (!strands || count <= 0) {
+        return -1;
+    }
+
+    int freeBlocks = kRmtTxBlocks - g_rmtBlocksUsed;
+    int autoCount = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!validLedType(strands[i].ledType)) {
+            ESP_LOGE(kTag, "Invalid LED type %d", strands[i].ledType);
+            return -1;
+        }
+        const ledParams_t& params = kLedParams[strands[i].ledType];
+        if (strands[i].rmtResolutionHz == 0) {
+            strands[i].rmtResolutionHz = autoResolution(params);
+        }
+        if (strands[i].rmtMemBlockSymbols > 0) {
+            freeBlocks -= blocksForSymbols(strands[i].rmtMemBlockSymbols);
+        } else {
+            ++autoCount;
+        }
+    }
+
+    if (freeBlocks < autoCount) {
+        ESP_LOGE(kTag, "%d strands need more than the %d free RMT blocks", count, kRmtTxBlocks - g_rmtBlocksUsed);
+        return -1;
+    }
+
+    // Every auto strand gets one block; spare blocks go to whichever strand
+    // pushes the most bits per block, since long frames refill most often.
+    int blocks[kMaxStrands] = {};
+    int spare = freeBlocks - autoCount;
+    for (int i = 0; i < count && i < kMaxStrands; ++i) {
+        blocks[i] = strands[i].rmtMemBlockSymbols > 0 ? 0 : 1;
+    }
+    while (spare > 0) {
+        int best = -1;
+        uint32_t bestLoad = 0;
+        for (int i = 0; i < count && i < kMaxStrands; ++i) {
+            if (blocks[i] == 0 || blocks[i] >= kRmtMaxBlocksPerStrand) {
+                continue;
+            }
+            const uint32_t bits = static_cast<uint32_t>(strands[i].numPixels) *
+                                  kLedParams[strands[i].ledType].bytesPerPixel * 8;
+            const uint32_t load = bits / static_cast<uint32_t>(blocks[i]);
+            if (best < 0 || load > bestLoad) {
+                best = i;
+                bestLoad = load;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        ++blocks[best];
+        --spare;
+    }
+
+    for (int i = 0; i < count && i < kMaxStrands; ++i) {
+        if (blocks[i] > 0) {
+            strands[i].rmtMemBlockSymbols = blocks[i] * static_cast<int>(kRmtBlockSymbols);
+        }
+    }
+
+    reserveStrands(g_strandCount + count);
+    return 0;
+}
+
 strand_t* LibStrip::addStrand(const strand_t& strand) {
     if (g_strandCount >= kMaxStrands) {
         ESP_LOGE(kTag, "Maximum strand count reached");
         return nullptr;
     }
 
-    if (strand.ledType < 0 || strand.ledType >= static_cast<int>(sizeof(kLedParams) / sizeof(kLedParams[0]))) {
+    if (!validLedType(strand.ledType)) {
         ESP_LOGE(kTag, "Invalid LED type %d", strand.ledType);
         return nullptr;
     }
 
     const ledParams_t& params = kLedParams[strand.ledType];
 
+    // Auto-sized strands keep their usual block count but never eat into the
+    // single block every strand still announced via reserveStrands() needs.
+    const int freeBlocks = kRmtTxBlocks - g_rmtBlocksUsed;
+    int memBlocks = 0;
+    if (strand.rmtMemBlockSymbols > 0) {
+        memBlocks = blocksForSymbols(strand.rmtMemBlockSymbols);
+    } else {
+        const int stillPlanned = std::max(g_rmtStrandsPlanned - g_strandCount - 1, 0);
+        memBlocks = std::min(baselineBlocks(params), freeBlocks - stillPlanned);
+    }
+    if (memBlocks < 1 || memBlocks > freeBlocks) {
+        ESP_LOGE(kTag, "Not enough RMT memory (%d of %d blocks free)", freeBlocks, kRmtTxBlocks);
+        return nullptr;
+    }
+
     auto* pixels = static_cast<pixelColor_t*>(calloc(strand.numPixels, sizeof(pixelColor_t)));
     if (!pixels) {
         ESP_LOGE(kTag, "Pixel buffer allocation failed");
@@ -575,20 +828,28 @@ strand_t* LibStrip::addStrand(const strand_t& strand) {
     ledConfig.external_pixel_buf = nullptr;
     ledConfig.flags.invert_out = 0;
     ledConfig.timings = timings;
+    ledConfig.full_refresh_interval = static_cast<uint32_t>(std::max(strand.fullRefreshInterval, 0));
 
     const bool isRgbw = params.bytesPerPixel == 4;
     le_led_strip_rmt_config_t rmtConfig = {};
     rmtConfig.clk_src = RMT_CLK_SRC_DEFAULT;
-    rmtConfig.resolution_hz = isRgbw ? 20000000 : 10000000;
-    rmtConfig.mem_block_symbols = isRgbw ? 96 : 0;
+    rmtConfig.resolution_hz = strand.rmtResolutionHz ? strand.rmtResolutionHz : autoResolution(params);
+    rmtConfig.mem_block_symbols = static_cast<size_t>(memBlocks) * kRmtBlockSymbols;
     rmtConfig.flags.with_dma = 0;
     rmtConfig.interrupt_priority = 0;
 
     const double tickNs = 1'000'000'000.0 / static_cast<double>(rmtConfig.resolution_hz);
     ESP_LOGI(kTag,
-             "LED type %d (%s) timings: T0H %.0fns (%u ticks) T0L %.0fns (%u ticks) T1H %.0fns (%u ticks) T1L %.0fns (%u ticks) reset %.0fns",
+             "LED type %d (%s) RMT %u Hz, %u symbols (%d/%d blocks)",
              strand.ledType,
              isRgbw ? "RGBW" : "RGB",
+             static_cast<unsigned>(rmtConfig.resolution_hz),
+             static_cast<unsigned>(rmtConfig.mem_block_symbols),
+             g_rmtBlocksUsed + memBlocks,
+             kRmtTxBlocks);
+    ESP_LOGI(kTag,
+             "LED type %d timings: T0H %.0fns (%u ticks) T0L %.0fns (%u ticks) T1H %.0fns (%u ticks) T1L %.0fns (%u ticks) reset %.0fus",
+             strand.ledType,
              static_cast<double>(timings.t0h), static_cast<uint32_t>(timings.t0h / tickNs + 0.5),
              static_cast<double>(timings.t0l), static_cast<uint32_t>(timings.t0l / tickNs + 0.5),
              static_cast<double>(timings.t1h), static_cast<uint32_t>(timings.t1h / tickNs + 0.5),
@@ -608,6 +869,20 @@ strand_t* LibStrip::addStrand(const strand_t& strand) {
     state->colorFormat = ledConfig.color_component_format;
     state->bytesPerPixel = params.bytesPerPixel;
     state->hasWhite = (params.bytesPerPixel == 4);
+    state->resolutionHz = rmtConfig.resolution_hz;
+    state->memBlocks = memBlocks;
+    state->bitPeriodNs = wireBitPeriodNs(timings, rmtConfig.resolution_hz);
+    state->resetUs = timings.reset;
+    state->windowStartUs = esp_timer_get_time();
+    state->telemetry.fullWireUs = wireTimeUs(*state, static_cast<uint32_t>(strand.numPixels));
+    state->telemetry.maxFps = static_cast<uint16_t>(
+        std::min<uint32_t>(1'000'000 / std::max<uint32_t>(state->telemetry.fullWireUs, 1), UINT16_MAX));
+    g_rmtBlocksUsed += memBlocks;
+
+    ESP_LOGI(kTag, "%d pixels: %u us on the wire per full frame, max %u FPS",
+             strand.numPixels,
+             static_cast<unsigned>(state->telemetry.fullWireUs),
+             static_cast<unsigned>(state->telemetry.maxFps));
 
     strand_t stored = strand;
     stored.pixels = pixels;
@@ -627,7 +902,12 @@ int LibStrip::updatePixels(strand_t* strand) {
         return -1;
     }
 
-    const int brightLimit = std::clamp(strand->brightLimit, 0, 255);
+    // 8.8 brightness, full scale at 255.0 so an 8-bit limit scales exactly as before
+    constexpr uint32_t kFullScale = 255u << 8;
+    const uint32_t brightScale = std::min<uint32_t>(
+        (static_cast<uint32_t>(std::clamp(strand->brightLimit, 0, 255)) << 8) |
+            static_cast<uint32_t>(std::clamp(strand->brightFine, 0, 255)),
+        kFullScale);
 
     for (int i = 0; i < strand->numPixels; ++i) {
         pixelColor_t color = strand->pixels[i];
@@ -637,13 +917,13 @@ int LibStrip::updatePixels(strand_t* strand) {
         uint8_t b = gamma8(color.b);
         uint8_t w = gamma8(color.w);
 
-        if (brightLimit == 0) {
+        if (brightScale == 0) {
             r = g = b = w = 0;
-        } else if (brightLimit < 255) {
-            r = static_cast<uint8_t>((static_cast<uint16_t>(r) * brightLimit) / 255);
-            g = static_cast<uint8_t>((static_cast<uint16_t>(g) * brightLimit) / 255);
-            b = static_cast<uint8_t>((static_cast<uint16_t>(b) * brightLimit) / 255);
-            w = static_cast<uint8_t>((static_cast<uint16_t>(w) * brightLimit) / 255);
+        } else if (brightScale < kFullScale) {
+            r = static_cast<uint8_t>((r * brightScale) / kFullScale);
+            g = static_cast<uint8_t>((g * brightScale) / kFullScale);
+            b = static_cast<uint8_t>((b * brightScale) / kFullScale);
+            w = static_cast<uint8_t>((w * brightScale) / kFullScale);
         }
 
         if (state->hasWhite) {
@@ -653,7 +933,19 @@ int LibStrip::updatePixels(strand_t* strand) {
         }
     }
 
-    return le_led_strip_refresh(state->stripHandle) == ESP_OK ? 0 : -1;
+    if (le_led_strip_refresh(state->stripHandle) != ESP_OK) {
+        return -1;
+    }
+    recordTransmit(*state, static_cast<uint32_t>(strand->numPixels));
+    return 0;
+}
+
+int LibStrip::getTelemetry(const strand_t* strand, strandTelemetry_t* telemetry) {
+    if (!strand || !strand->_stateVars || !telemetry) {
+        return -1;
+    }
+    *telemetry = reinterpret_cast<const DigitalLedsState*>(strand->_stateVars)->telemetry;
+    return 0;
 }
 
 void LibStrip::resetStrand(strand_t* strand) {
@@ -671,6 +963,7 @@ void LibStrip::resetStrand(strand_t* strand) {
         free(strand->pixels);
         strand->pixels = nullptr;
     }
+    g_rmtBlocksUsed = std::max(g_rmtBlocksUsed - state->memBlocks, 0);
     delete state;
     strand->_stateVars = nullptr;
 }
@@ -19,7 +19,11 @@ struct strand_t {
     int gpioNum = 0;
     int ledType = 0;
     int brightLimit = 255;
+    int brightFine = 0;  // Fractional LSB: scale = brightLimit + brightFine / 256
     int numPixels = 0;
+    int fullRefreshInterval = 60; // Frames between full-length transmits, 0 = always full
+    uint32_t rmtResolutionHz = 0;   // RMT tick rate, 0 = pick from LED timings
+    int rmtMemBlockSymbols = 0;     // RMT channel memory, 0 = share of the free blocks
     pixelColor_t* pixels = nullptr;
     void* _stateVars = nullptr;
 };
@@ -60,11 +64,36 @@ enum led_types {
     LED_TM1934,
 };
 
+// Per-strand transmit statistics. Wire times are the theoretical on-air
+// duration (worst-case bit period plus reset); tx times are measured from
+// rmt_transmit() to rmt_tx_wait_all_done().
+struct strandTelemetry_t {
+    uint32_t frames = 0;           // Transmits issued
+    uint32_t partialFrames = 0;    // Transmits shorter than the strip
+    uint32_t skippedFrames = 0;    // Refreshes with nothing changed
+    uint32_t lastPixelsSent = 0;
+    uint32_t lastTxUs = 0;
+    uint32_t avgTxUs = 0;
+    uint32_t maxTxUs = 0;
+    uint32_t lastWireUs = 0;
+    uint32_t fullWireUs = 0;       // Whole strip, what a full refresh costs
+    uint16_t maxFps = 0;           // 1 s / fullWireUs
+    uint8_t txEfficiencyPct = 0;   // lastWireUs vs lastTxUs, driver overhead shows up here
+    uint8_t linkUtilizationPct = 0; // Share of the last second the data line was busy
+};
+
 class LibStrip {
 public:
     static int init();
+    // Tells the allocator how many strands will exist so early strands leave
+    // RMT memory for later ones. addStrand() honours it for auto-sized strands.
+    static void reserveStrands(int count);
+    // Fills the auto (zero) RMT fields of a whole strand set at once, splitting
+    // the free memory blocks by bits per frame. Returns -1 if it cannot fit.
+    static int autoTuneRmt(strand_t* strands, int count);
     static strand_t* addStrand(const strand_t& strand);
     static int updatePixels(strand_t* strand);
+    static int getTelemetry(const strand_t* strand, strandTelemetry_t* telemetry);
     static void resetStrand(strand_t* strand);
 };
 
@@ -0,0 +1,27 @@
+// Host stand-in for LibStrip: strands are plain pixel buffers and nothing
+// is transmitted
+#include "libstrip.h"
+
+int LibStrip::init() { return 0; }
+
+void LibStrip::reserveStrands(int) {}
+
+int LibStrip::autoTuneRmt(strand_t*, int) { return 0; }
+
+strand_t* LibStrip::addStrand(const strand_t& strand) {
+    strand_t* copy = new strand_t(strand);
+    copy->pixels = new pixelColor_t[strand.numPixels]();
+    return copy;
+}
+
+int LibStrip::updatePixels(strand_t*) { return 0; }
+
+int LibStrip::getTelemetry(const strand_t*, strandTelemetry_t* telemetry) {
+    *telemetry = strandTelemetry_t();
+    return 0;
+}
+
+void LibStrip::resetStrand(strand_t* strand) {
+    delete[] strand->pixels;
+    delete strand;
+}
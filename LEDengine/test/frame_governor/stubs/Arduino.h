@@ -0,0 +1,15 @@
+// Host stand-in for the parts of Arduino.h LedEngine uses
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tests drive time by hand
+extern uint32_t g_hostMillis;
+inline uint32_t millis() { return g_hostMillis; }
+inline uint32_t micros() { return g_hostMillis * 1000; }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
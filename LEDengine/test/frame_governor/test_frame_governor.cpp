@@ -0,0 +1,114 @@
+// Host test for the LedEngine frame-rate governor: static looks fall back
+// to minFPS, moving ones keep targetFPS. Build and run with `make` here.
+#include "LedEngine.h"
+
+#include <stdio.h>
+
+using namespace LedEngineLib;
+
+uint32_t g_hostMillis = 1000;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK_EQ(actual, expected)                                              \
+    do {                                                                        \
+        const unsigned long a_ = (actual), e_ = (expected);                     \
+        if (a_ != e_) {                                                         \
+            printf("%s:%d: %s = %lu, expected %lu\n", __FILE__, __LINE__,       \
+                   #actual, a_, e_);                                            \
+            g_failures++;                                                       \
+        }                                                                       \
+    } while (0)
+
+constexpr uint8_t kTargetFps = 50;
+constexpr uint8_t kMinFps = 2;
+// LedEngine.cpp kStaticFramesBeforeIdle
+constexpr int kStaticFramesBeforeIdle = 3;
+
+LedEngineConfig makeConfig() {
+    LedEngineConfig config;
+    config.ledCount = 30;
+    config.targetFPS = kTargetFps;
+    config.minFPS = kMinFps;
+    return config;
+}
+
+LedEngineState makeState(AnimationMode mode, uint8_t speed) {
+    LedEngineState state;
+    state.masterBrightness = 255;
+    state.mode = mode;
+    state.animationSpeed = speed;
+    state.animationCtrl = 128;
+    state.colorA = ColorRGBW(255, 0, 0, 0);
+    state.colorB = ColorRGBW(0, 0, 255, 0);
+    return state;
+}
+
+// Renders frames of the same state at the target frame interval
+void renderFrames(LedEngine& engine, const LedEngineState& state, int frames) {
+    for (int i = 0; i < frames; i++) {
+        g_hostMillis += 1000 / kTargetFps;
+        engine.update(g_hostMillis, state);
+    }
+}
+
+void testSolidWithSpeedIdles() {
+    LedEngine engine(makeConfig());
+    CHECK_EQ(engine.begin(), true);
+    const LedEngineState state = makeState(ANIM_SOLID, 64);
+
+    // The first frame changes the strip; the static count starts after it
+    renderFrames(engine, state, kStaticFramesBeforeIdle);
+    CHECK_EQ(engine.getGovernedFPS(), kTargetFps);
+    renderFrames(engine, state, 1);
+    CHECK_EQ(engine.getGovernedFPS(), kMinFps);
+    renderFrames(engine, state, 10);
+    CHECK_EQ(engine.getGovernedFPS(), kMinFps);
+}
+
+void testNewLookWakesUp() {
+    LedEngine engine(makeConfig());
+    engine.begin();
+    LedEngineState state = makeState(ANIM_SOLID, 64);
+    renderFrames(engine, state, kStaticFramesBeforeIdle + 1);
+    CHECK_EQ(engine.getGovernedFPS(), kMinFps);
+
+    state.colorA = ColorRGBW(0, 255, 0, 0);
+    renderFrames(engine, state, 1);
+    CHECK_EQ(engine.getGovernedFPS(), kTargetFps);
+}
+
+void testSlowChaseKeepsRunning() {
+    LedEngine engine(makeConfig());
+    engine.begin();
+    // 1/256 LED per ms: most frames repeat the previous one
+    LedEngineState state = makeState(ANIM_CHASE, 0);
+    state.animationSpeedFine = 1;
+    renderFrames(engine, state, 50);
+    CHECK_EQ(engine.getGovernedFPS(), kTargetFps);
+}
+
+void testStoppedChaseIdles() {
+    LedEngine engine(makeConfig());
+    engine.begin();
+    renderFrames(engine, makeState(ANIM_CHASE, 0), kStaticFramesBeforeIdle + 1);
+    CHECK_EQ(engine.getGovernedFPS(), kMinFps);
+}
+
+}
+
+int main() {
+    testSolidWithSpeedIdles();
+    testNewLookWakesUp();
+    testSlowChaseKeepsRunning();
+    testStoppedChaseIdles();
+
+    if (g_failures) {
+        printf("frame_governor: %d failure(s)\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    printf("frame_governor: all checks passed\n");
+    return EXIT_SUCCESS;
+}
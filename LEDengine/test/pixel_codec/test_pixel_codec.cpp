@@ -0,0 +1,133 @@
+// Host round-trip test for PixelEncoder/PixelDecoder.
+// Build and run with `make` in this directory.
+#include "PixelCodec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using LedEngineLib::PixelDecoder;
+using LedEngineLib::PixelEncoder;
+
+namespace {
+
+int g_failures = 0;
+
+void fail(const char* what, unsigned iteration) {
+    printf("FAIL: %s (iteration %u)\n", what, iteration);
+    g_failures++;
+}
+
+// Frames with a mix of dark spans, unchanged spans and random bytes
+void mutate(std::mt19937& rng, std::vector<uint8_t>& frame) {
+    const uint32_t mode = rng() % 4;
+    for (size_t i = 0; i < frame.size(); i++) {
+        switch (mode) {
+            case 0: frame[i] = static_cast<uint8_t>(rng()); break;           // Noise
+            case 1: if (rng() % 16 == 0) frame[i] = static_cast<uint8_t>(rng()); break;  // Sparse change
+            case 2: frame[i] = (rng() % 3 == 0) ? 0 : static_cast<uint8_t>(rng()); break;  // Dark-ish
+            default: break;                                                 // Unchanged
+        }
+    }
+}
+
+// Feeds the encoded stream in random piece sizes, as radio chunks arrive
+bool decodeInPieces(std::mt19937& rng, const uint8_t* encoded, size_t encodedLen,
+                    uint8_t* reference, size_t referenceLen, bool delta, size_t streamLimit) {
+    PixelDecoder decoder;
+    decoder.begin(reference, referenceLen, delta, streamLimit);
+    size_t offset = 0;
+    while (offset < encodedLen) {
+        size_t piece = 1 + rng() % 250;
+        if (piece > encodedLen - offset) {
+            piece = encodedLen - offset;
+        }
+        if (!decoder.feed(encoded + offset, piece)) {
+            return false;
+        }
+        offset += piece;
+    }
+    return decoder.decodedBytes() == streamLimit && decoder.atTokenBoundary();
+}
+
+void testRoundTrip(unsigned iterations) {
+    std::mt19937 rng(12345);
+    for (unsigned it = 0; it < iterations; it++) {
+        const size_t len = 1 + rng() % 2400;  // Up to 600 RGBW pixels
+        std::vector<uint8_t> previous(len), current(len);
+        for (uint8_t& b : previous) b = static_cast<uint8_t>(rng());
+        current = previous;
+        mutate(rng, current);
+
+        const bool delta = rng() % 2;
+        std::vector<uint8_t> encoded(PixelEncoder::maxEncodedSize(len));
+        const size_t encodedLen = PixelEncoder::encode(current.data(), delta ? previous.data() : nullptr,
+                                                       len, encoded.data(), encoded.size());
+        if (encodedLen == 0) {
+            fail("encode exceeded maxEncodedSize", it);
+            continue;
+        }
+
+        // Full-length receiver
+        std::vector<uint8_t> reference = delta ? previous : std::vector<uint8_t>(len, 0xAA);
+        if (!decodeInPieces(rng, encoded.data(), encodedLen, reference.data(), len, delta, len) ||
+            reference != current) {
+            fail("round trip mismatch", it);
+            continue;
+        }
+
+        // Receiver with a shorter strip keeps the prefix
+        const size_t shortLen = rng() % (len + 1);
+        std::vector<uint8_t> shortRef(delta ? previous.begin() : reference.begin(),
+                                      (delta ? previous.begin() : reference.begin()) + shortLen);
+        if (!delta) {
+            std::fill(shortRef.begin(), shortRef.end(), 0x55);
+        }
+        if (!decodeInPieces(rng, encoded.data(), encodedLen, shortRef.data(), shortLen, delta, len) ||
+            (shortLen > 0 && memcmp(shortRef.data(), current.data(), shortLen) != 0)) {
+            fail("short reference mismatch", it);
+        }
+    }
+}
+
+void testCapacityAndLimits() {
+    std::vector<uint8_t> frame(300);
+    for (size_t i = 0; i < frame.size(); i++) {
+        frame[i] = static_cast<uint8_t>(i | 1);  // No zeros: all literals
+    }
+    std::vector<uint8_t> encoded(PixelEncoder::maxEncodedSize(frame.size()));
+    const size_t encodedLen = PixelEncoder::encode(frame.data(), nullptr, frame.size(),
+                                                   encoded.data(), encoded.size());
+    if (encodedLen == 0) {
+        fail("all-literal frame did not fit maxEncodedSize", 0);
+        return;
+    }
+    if (PixelEncoder::encode(frame.data(), nullptr, frame.size(), encoded.data(), encodedLen - 1) != 0) {
+        fail("encode overran a short buffer", 0);
+    }
+
+    // A stream decoding past its announced length is malformed
+    std::vector<uint8_t> reference(frame.size());
+    PixelDecoder decoder;
+    decoder.begin(reference.data(), reference.size(), false, frame.size() - 1);
+    if (decoder.feed(encoded.data(), encodedLen)) {
+        fail("decoder accepted a stream beyond streamLimit", 0);
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    const unsigned iterations = argc > 1 ? static_cast<unsigned>(atoi(argv[1])) : 20000;
+    testRoundTrip(iterations);
+    testCapacityAndLimits();
+    if (g_failures) {
+        printf("%d failure(s)\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    printf("pixel_codec: %u round trips passed\n", iterations);
+    return EXIT_SUCCESS;
+}
@@ -44,9 +44,35 @@
 // MIDI Configuration
 // ========================================
 #define MIDI_DEVICE_NAME "Midi2DMXnow"
+#define SERIAL_MIDI_RING_SIZE 256      // Bytes pulled from the UART per batch
+#define SERIAL_MIDI_MAX_PENDING_CC 32  // Distinct (channel, CC) pairs coalesced per batch
 #define MIDI_CHANNEL 1
 
-// MIDI CC Mappings
+// USB/serial MIDI is read by its own task (above loop() priority) and
+// handed to loop() as timestamped events, so display redraws delay when
+// input is applied but never when it is read. 0 polls from loop() instead.
+#ifndef MIDI_INPUT_TASK
+#define MIDI_INPUT_TASK 1
+#endif
+#define MIDI_INPUT_POLL_MS 1
+#define MIDI_INPUT_QUEUE_SIZE 128      // Events buffered while loop() is busy
+
+// High-resolution input. CC 0-31 pair with CC 32-63 as MSB/LSB into 14-bit
+// values (an LSB number that is mapped in its own right, like CC 32/33,
+// stays a 7-bit control). NRPN selects a parameter by its CC number with
+// CC 99/98 and writes it with data entry CC 6/38; CC 6 falls back to mirror
+// mode once no NRPN traffic was seen for MIDI_NRPN_TIMEOUT_MS.
+#ifndef MIDI_HIRES_CC
+#define MIDI_HIRES_CC 1
+#endif
+#define MIDI_NRPN_TIMEOUT_MS 2000
+
+// MIDI clock (24 ppqn) is tracked into a tempo and beat grid that rides in
+// every state packet; the tempo counts as lost after this long without clock
+#define MIDI_CLOCK_TIMEOUT_MS 500
+
+// Default CC map. CCMap (src/cc_map.h) looks controllers up in a
+// 128-entry table built from these; MIDI learn can rebind them at runtime.
 #define CC_MASTER_BRIGHTNESS 1
 #define CC_ANIMATION_SPEED 2
 #define CC_ANIMATION_CTRL 3
@@ -55,6 +81,7 @@
 #define CC_MIRROR_MODE 6
 #define CC_DIRECTION 7
 #define CC_ANIMATION_MODE 8
+#define CC_TEMPO_SYNC 9               // >= 64 locks animations to MIDI clock beats
 
 #define CC_COLOR_A_HUE 20
 #define CC_COLOR_A_SATURATION 21
@@ -68,6 +95,16 @@
 
 #define CC_SCENE_SAVE_MODE 127
 
+// Latency probe: value 1-127 is a probe id that is timestamped at every hop
+// down to the receivers' strip transmit (see controller/test_midi_jitter.py)
+#define CC_LATENCY_PROBE 119
+
+// MIDI learn: value n (1-18, CCTarget order) arms learning for a parameter,
+// the next CC moved takes it over; 0 cancels, 127 restores the defaults.
+// Learn and probe controllers are fixed and can't be rebound.
+#define CC_MIDI_LEARN 118
+#define MIDI_LEARN_TIMEOUT_MS 10000
+
 // MIDI Notes for Scene Triggers
 #define NOTE_SCENE_1 36
 #define NOTE_SCENE_2 37
@@ -85,11 +122,50 @@
 // DMX Configuration
 // ========================================
 #define DMX_UNIVERSE_SIZE 512
+// 1-based address of the zone this controller drives; receivers with the
+// same start address follow it, others in the universe are left untouched
+#ifndef DMX_START_ADDRESS
 #define DMX_START_ADDRESS 1
+#endif
 #ifndef DMX_UNIVERSE_ID
 #define DMX_UNIVERSE_ID 0
 #endif
 
+// Wire format: compact 58-byte LeslieProtocol state packets, or the full
+// 512-byte ESPNowDMX universe for receivers running older firmware.
+#define DMX_PACKET_COMPACT 0
+#define DMX_PACKET_UNIVERSE 1
+#ifndef DMX_PACKET_MODE
+#define DMX_PACKET_MODE DMX_PACKET_COMPACT
+#endif
+
+// Frames go out as soon as the state changes, but no closer together than
+// the minimum interval. An unchanged state is repeated at the keep-alive
+// rate so late joiners and lossy links still converge.
+#define DMX_SEND_MIN_INTERVAL_MS 10   // caps changes at ~100 Hz
+#define DMX_KEEPALIVE_MS 500          // 2 Hz while idle
+#define DMX_TEMPO_RESEND_PERMILLE 5   // Tempo drift that triggers an immediate send
+
+// Slew time constants (ms) for continuous parameters: 7-bit CC steps are
+// smoothed into a one-pole fade at the DMX send rate. 0 = apply instantly.
+#define DMX_SLEW_TICK_MS 10
+#define DMX_SLEW_BRIGHTNESS_MS 80
+#define DMX_SLEW_SPEED_MS 150
+#define DMX_SLEW_CTRL_MS 60
+#define DMX_SLEW_HUE_MS 120
+#define DMX_SLEW_COLOR_MS 80          // Saturation, value, white
+
+// Stream the preview strip's pixels to receivers in direct pixel mode
+// (RGB keyframe/delta coded, 128-byte chunks on consecutive universes from
+// PIXEL_STREAM_UNIVERSE)
+#ifndef PIXEL_STREAM_ENABLED
+#define PIXEL_STREAM_ENABLED 0
+#endif
+#define PIXEL_STREAM_UNIVERSE 1
+#define PIXEL_STREAM_FPS 30
+#define PIXEL_KEYFRAME_INTERVAL 30    // Frames between keyframes (loss recovery time)
+#define PIXEL_CHUNKS_PER_PASS 4       // Chunks queued per loop pass; the rest wait
+
 // DMX Channel Layout (32 channels total)
 #define DMX_CH_MASTER_BRIGHTNESS 0    // 0-255
 #define DMX_CH_ANIMATION_MODE 1       // 0-255 (0-25 per mode)
@@ -110,12 +186,22 @@
 #define DMX_CH_COLOR_B_VALUE 14       // 0-255
 #define DMX_CH_COLOR_B_WHITE 15       // 0-255
 
-// Channels 16-31 reserved for future use
+// Channels 16-31 carry the fine (LSB) byte of channel N at N + 16, so the
+// parameter is coarse + fine / 256. Only brightness, speed and the two hues
+// use them; the other fine channels stay 0.
+#define DMX_CH_FINE_OFFSET 16
 
 // ========================================
 // Scene Configuration
 // ========================================
-#define MAX_SCENES 10
+#define MAX_SCENES 128                 // Notes reach 1-10, Program Change 0-127 all
+
+// SysEx scene bank transfer (protocol in scene_sysex.h)
+#define SYSEX_MANUFACTURER_ID 0x7D     // Non-commercial / educational use
+#define SYSEX_DEVICE_ID 0x4C           // 'L'
+#define MIDI_SYSEX_MAX_BYTES 64        // Longest message accepted, F0..F7 inclusive
+#define MIDI_SYSEX_QUEUE_SIZE 4        // Complete messages waiting for loop()
+#define SYSEX_BANK_TIMEOUT_MS 5000     // Uploads idle this long are abandoned
 
 // ========================================
 // Debug Configuration
@@ -130,6 +216,7 @@
 #define DISPLAY_BRIGHTNESS 128
 #define DISPLAY_UPDATE_MS 50
 #define MIDI_LOG_LINES 8
+#define MIDI_EVENT_LOG_SIZE 32     // Binary MIDI -> display ring (power of two)
 
 // Display colors (RGB565 format)
 #define COLOR_BG 0x0000
@@ -0,0 +1,144 @@
+#include "cc_map.h"
+
+constexpr CCMap::Binding CCMap::DEFAULT_BINDINGS[];
+constexpr const char* CCMap::STORAGE_NAMESPACE;
+constexpr const char* CCMap::STORAGE_KEY;
+constexpr uint8_t CCMap::CHANNEL_MODE_FIRST;
+
+namespace {
+
+const char* const kLearnLabels[CC_TARGET_COUNT] = {
+    "Learn: off",
+    "Learn: Brightness",
+    "Learn: Speed",
+    "Learn: Control",
+    "Learn: Strobe",
+    "Learn: Blend",
+    "Learn: Mirror",
+    "Learn: Direction",
+    "Learn: Mode",
+    "Learn: Tempo Sync",
+    "Learn: Hue A",
+    "Learn: Sat A",
+    "Learn: Value A",
+    "Learn: White A",
+    "Learn: Hue B",
+    "Learn: Sat B",
+    "Learn: Value B",
+    "Learn: White B",
+    "Learn: Save Mode",
+};
+
+}
+
+CCMap::CCMap()
+    : _learnTarget(CC_TARGET_NONE)
+    , _learnStartMs(0)
+    , _prefsReady(false) {
+    loadDefaults();
+}
+
+CCMap::~CCMap() {
+    if (_prefsReady) {
+        _preferences.end();
+        _prefsReady = false;
+    }
+}
+
+void CCMap::begin() {
+    if (!_prefsReady) {
+        _prefsReady = _preferences.begin(STORAGE_NAMESPACE, false);
+    }
+    if (!loadFromStorage()) {
+        loadDefaults();
+    }
+}
+
+bool CCMap::bind(uint8_t controller, CCTarget target) {
+    if (controller > 127 || target == CC_TARGET_NONE || target >= CC_TARGET_COUNT) {
+        return false;
+    }
+    // One controller per parameter: the previous one goes quiet
+    for (uint8_t cc = 0; cc < 128; cc++) {
+        if (_targets[cc] == target) {
+            _targets[cc] = CC_TARGET_NONE;
+        }
+    }
+    _targets[controller] = target;
+    #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
+    Serial.printf("CC %d -> target %d\n", controller, target);
+    #endif
+    return persist();
+}
+
+void CCMap::resetToDefaults() {
+    loadDefaults();
+    if (_prefsReady) {
+        _preferences.remove(STORAGE_KEY);
+    }
+}
+
+void CCMap::beginLearn(CCTarget target, uint32_t nowMs) {
+    _learnTarget = target < CC_TARGET_COUNT ? target : CC_TARGET_NONE;
+    _learnStartMs = nowMs;
+}
+
+bool CCMap::isLearning(uint32_t nowMs) const {
+    return _learnTarget != CC_TARGET_NONE && nowMs - _learnStartMs <= MIDI_LEARN_TIMEOUT_MS;
+}
+
+bool CCMap::learn(uint8_t controller, uint32_t nowMs, CCTarget* replaced) {
+    if (!isLearning(nowMs)) {
+        _learnTarget = CC_TARGET_NONE;
+        return false;
+    }
+    if (controller >= CHANNEL_MODE_FIRST) {
+        return false;  // Panic/reset messages; keep waiting for a knob
+    }
+    const CCTarget target = _learnTarget;
+    _learnTarget = CC_TARGET_NONE;
+    if (replaced) {
+        *replaced = lookup(controller) != target ? lookup(controller) : CC_TARGET_NONE;
+    }
+    bind(controller, target);
+    return true;
+}
+
+const char* CCMap::learnLabel(CCTarget target) {
+    return target < CC_TARGET_COUNT ? kLearnLabels[target] : kLearnLabels[CC_TARGET_NONE];
+}
+
+void CCMap::loadDefaults() {
+    memset(_targets, CC_TARGET_NONE, sizeof(_targets));
+    for (const Binding& binding : DEFAULT_BINDINGS) {
+        _targets[binding.controller] = binding.target;
+    }
+}
+
+bool CCMap::loadFromStorage() {
+    if (!_prefsReady || _preferences.getBytesLength(STORAGE_KEY) != sizeof(StorageBlock)) {
+        return false;
+    }
+    StorageBlock block;
+    if (_preferences.getBytes(STORAGE_KEY, &block, sizeof(block)) != sizeof(block) ||
+        block.magic != STORAGE_MAGIC) {
+        return false;
+    }
+    for (uint8_t cc = 0; cc < 128; cc++) {
+        if (block.targets[cc] >= CC_TARGET_COUNT) {
+            return false;  // Written by a build with more targets
+        }
+    }
+    memcpy(_targets, block.targets, sizeof(_targets));
+    return true;
+}
+
+bool CCMap::persist() {
+    if (!_prefsReady) {
+        return false;
+    }
+    StorageBlock block;
+    block.magic = STORAGE_MAGIC;
+    memcpy(block.targets, _targets, sizeof(block.targets));
+    return _preferences.putBytes(STORAGE_KEY, &block, sizeof(block)) == sizeof(block);
+}
@@ -0,0 +1,121 @@
+#ifndef CC_MAP_H
+#define CC_MAP_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+/**
+ * Parameters a CC can drive. Values 1 to CC_TARGET_COUNT - 1 are also the
+ * CC_MIDI_LEARN values that arm learning for that parameter.
+ */
+enum CCTarget : uint8_t {
+    CC_TARGET_NONE = 0,
+    CC_TARGET_MASTER_BRIGHTNESS,
+    CC_TARGET_ANIMATION_SPEED,
+    CC_TARGET_ANIMATION_CTRL,
+    CC_TARGET_STROBE_RATE,
+    CC_TARGET_BLEND_MODE,
+    CC_TARGET_MIRROR_MODE,
+    CC_TARGET_DIRECTION,
+    CC_TARGET_ANIMATION_MODE,
+    CC_TARGET_TEMPO_SYNC,
+    CC_TARGET_COLOR_A_HUE,
+    CC_TARGET_COLOR_A_SATURATION,
+    CC_TARGET_COLOR_A_VALUE,
+    CC_TARGET_COLOR_A_WHITE,
+    CC_TARGET_COLOR_B_HUE,
+    CC_TARGET_COLOR_B_SATURATION,
+    CC_TARGET_COLOR_B_VALUE,
+    CC_TARGET_COLOR_B_WHITE,
+    CC_TARGET_SCENE_SAVE_MODE,
+    CC_TARGET_COUNT
+};
+
+/**
+ * CCMap - 128-entry controller -> parameter table. Lookup is a single
+ * array index; the table starts from the config.h CC_* assignments and
+ * can be rebound at runtime with MIDI learn. Rebinding stores the table
+ * in NVS, so it survives reboots until reset to the defaults.
+ *
+ * Learn: arm a target, then move the knob to use. The next CC on the
+ * active channel takes over the target (the CC that drove it before is
+ * unbound); learning lapses after MIDI_LEARN_TIMEOUT_MS. Channel mode
+ * messages (CC 120-127) are never learned.
+ */
+class CCMap {
+public:
+    struct Binding {
+        uint8_t controller;
+        CCTarget target;
+    };
+
+    static constexpr Binding DEFAULT_BINDINGS[] = {
+        {CC_MASTER_BRIGHTNESS, CC_TARGET_MASTER_BRIGHTNESS},
+        {CC_ANIMATION_SPEED, CC_TARGET_ANIMATION_SPEED},
+        {CC_ANIMATION_CTRL, CC_TARGET_ANIMATION_CTRL},
+        {CC_STROBE_RATE, CC_TARGET_STROBE_RATE},
+        {CC_BLEND_MODE, CC_TARGET_BLEND_MODE},
+        {CC_MIRROR_MODE, CC_TARGET_MIRROR_MODE},
+        {CC_DIRECTION, CC_TARGET_DIRECTION},
+        {CC_ANIMATION_MODE, CC_TARGET_ANIMATION_MODE},
+        {CC_TEMPO_SYNC, CC_TARGET_TEMPO_SYNC},
+        {CC_COLOR_A_HUE, CC_TARGET_COLOR_A_HUE},
+        {CC_COLOR_A_SATURATION, CC_TARGET_COLOR_A_SATURATION},
+        {CC_COLOR_A_VALUE, CC_TARGET_COLOR_A_VALUE},
+        {CC_COLOR_A_WHITE, CC_TARGET_COLOR_A_WHITE},
+        {CC_COLOR_B_HUE, CC_TARGET_COLOR_B_HUE},
+        {CC_COLOR_B_SATURATION, CC_TARGET_COLOR_B_SATURATION},
+        {CC_COLOR_B_VALUE, CC_TARGET_COLOR_B_VALUE},
+        {CC_COLOR_B_WHITE, CC_TARGET_COLOR_B_WHITE},
+        {CC_SCENE_SAVE_MODE, CC_TARGET_SCENE_SAVE_MODE},
+    };
+
+    CCMap();
+    ~CCMap();
+
+    // Loads the stored table, if any
+    void begin();
+
+    CCTarget lookup(uint8_t controller) const { return static_cast<CCTarget>(_targets[controller & 0x7F]); }
+    bool isMapped(uint8_t controller) const { return _targets[controller & 0x7F] != CC_TARGET_NONE; }
+
+    // First channel mode controller (All Sound Off); these can't be learned
+    static constexpr uint8_t CHANNEL_MODE_FIRST = 120;
+
+    // Moves target to controller and persists the table
+    bool bind(uint8_t controller, CCTarget target);
+    void resetToDefaults();
+
+    void beginLearn(CCTarget target, uint32_t nowMs);
+    void cancelLearn() { _learnTarget = CC_TARGET_NONE; }
+    bool isLearning(uint32_t nowMs) const;
+    // Binds controller if learning; returns true if it did. replaced gets
+    // the target the controller drove before, which is now unbound
+    bool learn(uint8_t controller, uint32_t nowMs, CCTarget* replaced = nullptr);
+
+    // "Learn: <name>" status text for the display
+    static const char* learnLabel(CCTarget target);
+
+private:
+    static constexpr uint32_t STORAGE_MAGIC = 0x43434D31; // 'CCM1'
+    static constexpr const char* STORAGE_NAMESPACE = "ccMap";
+    static constexpr const char* STORAGE_KEY = "table";
+
+    struct StorageBlock {
+        uint32_t magic;
+        uint8_t targets[128];
+    };
+
+    uint8_t _targets[128];
+    CCTarget _learnTarget;
+    uint32_t _learnStartMs;
+    Preferences _preferences;
+    bool _prefsReady;
+
+    void loadDefaults();
+    bool loadFromStorage();
+    bool persist();
+};
+
+#endif // CC_MAP_H
@@ -4,6 +4,7 @@ DisplayHandler::DisplayHandler()
     : _ledEngine(nullptr)
     , _dmxState(nullptr)
     , _logIndex(0)
+    , _logChanged(false)
     , _lastUpdate(0)
     , _sceneNotificationEnd(0)
     , _sceneNotificationNumber(0)
@@ -12,8 +13,7 @@ DisplayHandler::DisplayHandler()
     , _currentPage(0)
     , _lastPreviewUpdate(0) {
     for (int i = 0; i < MIDI_LOG_LINES; i++) {
-        _logEntries[i].text[0] = '\0';
-        _logEntries[i].timestamp = 0;
+        _logHistory[i] = MidiLogEvent();
     }
 
     _lastState.mode = LedEngineLib::ANIM_SOLID;
@@ -22,7 +22,6 @@ DisplayHandler::DisplayHandler()
     _lastState.fps = 0;
     _lastState.colorA = LedEngineLib::ColorRGBW();
     _lastState.colorB = LedEngineLib::ColorRGBW();
-    _lastState.lastLogIndex = -1;
 }
 
 void DisplayHandler::begin() {
@@ -49,6 +48,10 @@ void DisplayHandler::update() {
 #if DISPLAY_ENABLED
     unsigned long now = millis();
 
+    // Always drain so the MIDI side never sees a full ring; records are
+    // only copied here, formatting waits for the log page.
+    drainEventLog();
+
     if (now < _sceneNotificationEnd) {
         drawSceneNotification();
         return;
@@ -69,9 +72,12 @@ void DisplayHandler::update() {
             return;
         }
         _lastUpdate = now;
-        if (_needsFullRedraw || hasStateChanged()) {
+        // Log traffic only repaints the log area of the log page
+        if (_needsFullRedraw || (_currentPage == 1 && hasStateChanged())) {
             drawUI();
             _needsFullRedraw = false;
+        } else if (_currentPage == 2 && _logChanged) {
+            drawMessageLog();
         }
     }
 #endif
@@ -79,14 +85,23 @@ void DisplayHandler::update() {
 
 void DisplayHandler::logMessage(const char* message) {
 #if DISPLAY_ENABLED
-    strncpy(_logEntries[_logIndex].text, message, 31);
-    _logEntries[_logIndex].text[31] = '\0';
-    _logEntries[_logIndex].timestamp = millis();
-    _logIndex = (_logIndex + 1) % MIDI_LOG_LINES;
-    _needsFullRedraw = true;
+    appendLog(MidiLogEvent::status(message));
 #endif
 }
 
+void DisplayHandler::appendLog(const MidiLogEvent& event) {
+    _logHistory[_logIndex] = event;
+    _logIndex = (_logIndex + 1) % MIDI_LOG_LINES;
+    _logChanged = true;
+}
+
+void DisplayHandler::drainEventLog() {
+    MidiLogEvent event;
+    while (_eventLog.pop(event)) {
+        appendLog(event);
+    }
+}
+
 void DisplayHandler::showSceneNotification(uint8_t sceneNumber, bool isSave) {
 #if DISPLAY_ENABLED
     _sceneNotificationNumber = sceneNumber;
@@ -214,18 +229,21 @@ void DisplayHandler::drawMessageLog() {
     M5.Display.setTextColor(COLOR_MIDI_CC, COLOR_BG);
     M5.Display.setTextSize(1);
 
+    char text[32];
     int displayLine = 0;
     for (int i = 0; i < MIDI_LOG_LINES && displayLine < 7; i++) {
         int logIdx = (_logIndex - 1 - i + MIDI_LOG_LINES) % MIDI_LOG_LINES;
-        if (_logEntries[logIdx].text[0] != '\0') {
+        if (_logHistory[logIdx].type != MidiLogEvent::NONE) {
             int y = logStartY + (displayLine * lineHeight);
             if (y + lineHeight <= h) {
+                _logHistory[logIdx].format(text, sizeof(text));
                 M5.Display.setCursor(2, y);
-                M5.Display.print(_logEntries[logIdx].text);
+                M5.Display.print(text);
                 displayLine++;
             }
         }
     }
+    _logChanged = false;
 #endif
 }
 
@@ -307,11 +325,6 @@ bool DisplayHandler::hasStateChanged() {
         changed = true;
     }
 
-    if (_logIndex != _lastState.lastLogIndex) {
-        _lastState.lastLogIndex = _logIndex;
-        changed = true;
-    }
-
     return changed;
 }
 
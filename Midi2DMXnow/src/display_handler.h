@@ -7,6 +7,7 @@
 #include "config.h"
 #include "dmx_state.h"
 #include "led_preview_renderer.h"
+#include "midi_event_log.h"
 
 class DisplayHandler {
 public:
@@ -17,7 +18,12 @@ public:
 
     void setLedEngine(LedEngineLib::LedEngine* engine);
     void setDMXState(DMXState* state);
+    // Display context only (e.g. begin()). The MIDI path uses logEvent().
     void logMessage(const char* message);
+    // MIDI context: lock-free, no formatting; text is built when the log
+    // page is drawn.
+    void logEvent(const MidiLogEvent& event) { _eventLog.push(event); }
+    uint32_t getDroppedLogEvents() const { return _eventLog.getDropped(); }
     void showSceneNotification(uint8_t sceneNumber, bool isSave);
     void handleButtonPress();
 
@@ -25,13 +31,10 @@ private:
     LedEngineLib::LedEngine* _ledEngine;
     DMXState* _dmxState;
 
-    struct LogEntry {
-        char text[32];
-        unsigned long timestamp;
-    };
-
-    LogEntry _logEntries[MIDI_LOG_LINES];
-    int _logIndex;
+    MidiEventLog _eventLog;
+    MidiLogEvent _logHistory[MIDI_LOG_LINES];
+    uint8_t _logIndex;
+    bool _logChanged;
 
     unsigned long _lastUpdate;
     unsigned long _sceneNotificationEnd;
@@ -48,7 +51,6 @@ private:
         LedEngineLib::ColorRGBW colorA;
         LedEngineLib::ColorRGBW colorB;
         uint8_t fps;
-        int lastLogIndex;
     } _lastState;
 
     static constexpr uint8_t PAGE_COUNT = 3;
@@ -61,6 +63,8 @@ private:
     void drawStatusBar();
     void drawInfoPanel();
     void drawMessageLog();
+    void appendLog(const MidiLogEvent& event);
+    void drainEventLog();
     void drawSceneNotification();
     bool hasStateChanged();
     LedEngineLib::LedEngineState currentEngineState() const;
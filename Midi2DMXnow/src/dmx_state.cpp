@@ -1,12 +1,27 @@
 #include "dmx_state.h"
+#include <algorithm>
+#include <new>
 
 using LedEngineLib::ColorRGBW;
 using LedEngineLib::DirectionMode;
 using LedEngineLib::LedEngineState;
 using LedEngineLib::MirrorMode;
 
+constexpr const char* DMXState::SCENE_STORAGE_KEYS[2];
+
 namespace {
 
+uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
 MirrorMode decodeMirror(uint8_t value) {
     if (value < 51) return LedEngineLib::MIRROR_NONE;
     if (value < 102) return LedEngineLib::MIRROR_FULL;
@@ -22,6 +37,21 @@ DirectionMode decodeDirection(uint8_t value) {
     return LedEngineLib::DIR_RANDOM;
 }
 
+// 8.8 parameter level from an 8-bit DMX value
+uint16_t level16(uint8_t value) {
+    return static_cast<uint16_t>(value) << 8;
+}
+
+// 14-bit MIDI to 8.8 with 16383 -> 255.0, matching map(0..127 -> 0..255)
+uint16_t toLevel(uint16_t value14) {
+    return static_cast<uint16_t>((static_cast<uint32_t>(value14) * (255u << 8)) / 16383u);
+}
+
+// Hue is circular: 16383 lands just short of 0 instead of on it
+uint16_t toHue(uint16_t value14) {
+    return static_cast<uint16_t>(value14 << 2);
+}
+
 }
 
 DMXState::DMXState() 
@@ -34,12 +64,24 @@ DMXState::DMXState()
     , _mirror(0)
     , _direction(0)
     , _sceneSaveMode(false)
+    , _tempoSync(false)
+    , _probe()
+    , _version(0)
+    , _lastSlewMs(0)
     , _currentScene(-1)
     , _prefsReady(false)
+    , _bankGeneration(0)
+    , _bankSlot(1)
 {
     // Initialize with default colors (HSV format)
     _colorA = HSVColor(0, 255, 255, 0);      // Red
     _colorB = HSVColor(160, 255, 255, 0);    // Cyan
+
+    memset(_frame, 0, sizeof(_frame));
+    memset(_dirty, 0, sizeof(_dirty));
+    initParams();
+    initSlew();
+    packFrame();
 }
 
 DMXState::~DMXState() {
@@ -60,82 +102,52 @@ void DMXState::begin() {
         persistScenes();
     }
     
-    #if DEBUG_MODE
+    #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
     Serial.println("DMX State initialized");
     Serial.printf("Default mode: ANIM_SOLID, Color A (red HSV)\n");
     #endif
 }
 
-void DMXState::handleGlobalCC(byte controller, byte value) {
-    switch (controller) {
-        case CC_MASTER_BRIGHTNESS:
-            _masterBrightness = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_ANIMATION_SPEED:
-            _animationSpeed = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_ANIMATION_CTRL:
-            _animationCtrl = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_STROBE_RATE:
-            _strobeRate = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_BLEND_MODE:
-            _blendMode = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_MIRROR_MODE:
-            _mirror = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_DIRECTION:
-            _direction = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_ANIMATION_MODE:
+void DMXState::handleParameter(CCTarget target, uint16_t value14) {
+    if (target >= CC_TARGET_COUNT) {
+        return;
+    }
+
+    const ParamSlot& slot = _params[target];
+    if (slot.coarse) {
+        const uint16_t level = slot.scale(value14);
+        *slot.coarse = level >> 8;
+        setParam(slot.channel, level);
+        return;
+    }
+
+    switch (target) {
+        case CC_TARGET_ANIMATION_MODE:
             // Map 0-127 to animation modes
             {
-                uint8_t mode = value / (128 / LedEngineLib::ANIM_MODE_COUNT);
+                uint8_t mode = (value14 >> 7) / (128 / LedEngineLib::ANIM_MODE_COUNT);
                 if (mode >= LedEngineLib::ANIM_MODE_COUNT) {
                     mode = LedEngineLib::ANIM_MODE_COUNT - 1;
                 }
                 _currentMode = static_cast<AnimationMode>(mode);
+                setParam(DMX_CH_ANIMATION_MODE, level16((uint8_t)_currentMode * 25));
             }
             break;
             
-        case CC_SCENE_SAVE_MODE:
-            // Require a bit of headroom to avoid noisy knob flickers enabling save mode accidentally
-            _sceneSaveMode = (value >= 64);
+        case CC_TARGET_TEMPO_SYNC:
+            // Travels as a packet flag rather than a channel; still a state change
+            if (((value14 >> 7) >= 64) != _tempoSync) {
+                _tempoSync = !_tempoSync;
+                _version++;
+            }
             break;
-    }
-}
 
-void DMXState::handleColorCC(uint8_t colorBank, byte controller, byte value) {
-    HSVColor* targetColor = (colorBank == 0) ? &_colorA : &_colorB;
-    
-    switch (controller) {
-        case CC_COLOR_A_HUE:
-        case CC_COLOR_B_HUE:
-            targetColor->hue = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_COLOR_A_SATURATION:
-        case CC_COLOR_B_SATURATION:
-            targetColor->saturation = map(value, 0, 127, 0, 255);
-            break;
-            
-        case CC_COLOR_A_VALUE:
-        case CC_COLOR_B_VALUE:
-            targetColor->value = map(value, 0, 127, 0, 255);
+        case CC_TARGET_SCENE_SAVE_MODE:
+            // Require a bit of headroom to avoid noisy knob flickers enabling save mode accidentally
+            _sceneSaveMode = ((value14 >> 7) >= 64);
             break;
-            
-        case CC_COLOR_A_WHITE:
-        case CC_COLOR_B_WHITE:
-            targetColor->white = map(value, 0, 127, 0, 255);
+
+        default:
             break;
     }
 }
@@ -144,32 +156,15 @@ DMXState::SceneEvent DMXState::handleNoteOn(byte note, byte velocity) {
     SceneEvent event;
     // Scene recall notes (36-45)
     if (note >= NOTE_SCENE_1 && note <= NOTE_SCENE_10) {
-        uint8_t sceneIndex = note - NOTE_SCENE_1;
-        event.triggered = true;
-        event.sceneIndex = sceneIndex;
-        
-        if (_sceneSaveMode) {
-            // Save mode: store current state
-            saveCurrentAsScene(sceneIndex);
-            event.saved = true;
-            _sceneSaveMode = false;
-            #if DEBUG_MODE
-            Serial.printf("Saved scene %d\n", sceneIndex + 1);
-            #endif
-        } else {
-            // Load mode: recall scene
-            loadScene(sceneIndex);
-            #if DEBUG_MODE
-            Serial.printf("Loaded scene %d\n", sceneIndex + 1);
-            #endif
-        }
+        event = triggerScene(note - NOTE_SCENE_1);
     }
     // Blackout note
     else if (note == NOTE_BLACKOUT) {
         _masterBrightness = 0;
+        snapParam(DMX_CH_MASTER_BRIGHTNESS, 0);
         event.triggered = true;
         event.blackout = true;
-        #if DEBUG_MODE
+        #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
         Serial.println("Blackout triggered");
         #endif
     }
@@ -180,45 +175,242 @@ void DMXState::handleNoteOff(byte note) {
     // Currently no action on note off
 }
 
+DMXState::SceneEvent DMXState::handleProgramChange(byte program) {
+    if (program >= MAX_SCENES) {
+        return SceneEvent();
+    }
+    return triggerScene(program);
+}
+
+DMXState::SceneEvent DMXState::triggerScene(uint8_t sceneIndex) {
+    SceneEvent event;
+    event.triggered = true;
+    event.sceneIndex = sceneIndex;
+
+    if (_sceneSaveMode) {
+        // Save mode: store current state
+        saveCurrentAsScene(sceneIndex);
+        event.saved = true;
+        _sceneSaveMode = false;
+        #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
+        Serial.printf("Saved scene %d\n", sceneIndex + 1);
+        #endif
+    } else {
+        // Load mode: recall scene
+        loadScene(sceneIndex);
+        #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
+        Serial.printf("Loaded scene %d\n", sceneIndex + 1);
+        #endif
+    }
+    return event;
+}
+
 void DMXState::toDMXFrame(uint8_t* dmxData, uint16_t size) {
     if (size < 32) return; // Need at least 32 channels
-    
-    // Clear frame
-    memset(dmxData, 0, size);
-    
+
+    uint16_t count = size < DMX_UNIVERSE_SIZE ? size : DMX_UNIVERSE_SIZE;
+    memcpy(dmxData, _frame, count);
+    if (size > count) {
+        memset(dmxData + count, 0, size - count);
+    }
+}
+
+bool DMXState::isChannelDirty(uint16_t channel) const {
+    if (channel >= DMX_UNIVERSE_SIZE) return false;
+    return (_dirty[channel >> 5] & (1UL << (channel & 31))) != 0;
+}
+
+bool DMXState::getDirtySpan(uint16_t& first, uint16_t& last) const {
+    bool found = false;
+    for (uint16_t word = 0; word < DIRTY_WORDS; word++) {
+        uint32_t bits = _dirty[word];
+        if (!bits) continue;
+        uint16_t lo = (word << 5) + __builtin_ctz(bits);
+        uint16_t hi = (word << 5) + 31 - __builtin_clz(bits);
+        if (!found) {
+            first = lo;
+            found = true;
+        }
+        last = hi;
+    }
+    return found;
+}
+
+void DMXState::setLatencyProbe(uint8_t id, uint32_t readUs) {
+    _probe.id = id;
+    _probe.readUs = readUs;
+    _probe.appliedUs = micros();
+    _version++;
+}
+
+void DMXState::clearDirty() {
+    memset(_dirty, 0, sizeof(_dirty));
+}
+
+void DMXState::setChannel(uint16_t channel, uint8_t value) {
+    channel += DMX_START_ADDRESS - 1;  // DMX_CH_* are zone-relative
+    if (channel >= DMX_UNIVERSE_SIZE || _frame[channel] == value) {
+        return;
+    }
+    _frame[channel] = value;
+    _dirty[channel >> 5] |= (1UL << (channel & 31));
+    _version++;
+}
+
+void DMXState::initParams() {
+    memset(_params, 0, sizeof(_params));
+    _params[CC_TARGET_MASTER_BRIGHTNESS] = {&_masterBrightness, DMX_CH_MASTER_BRIGHTNESS, toLevel};
+    _params[CC_TARGET_ANIMATION_SPEED] = {&_animationSpeed, DMX_CH_ANIMATION_SPEED, toLevel};
+    _params[CC_TARGET_ANIMATION_CTRL] = {&_animationCtrl, DMX_CH_ANIMATION_CTRL, toLevel};
+    _params[CC_TARGET_STROBE_RATE] = {&_strobeRate, DMX_CH_STROBE_RATE, toLevel};
+    _params[CC_TARGET_BLEND_MODE] = {&_blendMode, DMX_CH_BLEND_MODE, toLevel};
+    _params[CC_TARGET_MIRROR_MODE] = {&_mirror, DMX_CH_MIRROR_MODE, toLevel};
+    _params[CC_TARGET_DIRECTION] = {&_direction, DMX_CH_DIRECTION, toLevel};
+
+    _params[CC_TARGET_COLOR_A_HUE] = {&_colorA.hue, DMX_CH_COLOR_A_HUE, toHue};
+    _params[CC_TARGET_COLOR_A_SATURATION] = {&_colorA.saturation, DMX_CH_COLOR_A_SATURATION, toLevel};
+    _params[CC_TARGET_COLOR_A_VALUE] = {&_colorA.value, DMX_CH_COLOR_A_VALUE, toLevel};
+    _params[CC_TARGET_COLOR_A_WHITE] = {&_colorA.white, DMX_CH_COLOR_A_WHITE, toLevel};
+    _params[CC_TARGET_COLOR_B_HUE] = {&_colorB.hue, DMX_CH_COLOR_B_HUE, toHue};
+    _params[CC_TARGET_COLOR_B_SATURATION] = {&_colorB.saturation, DMX_CH_COLOR_B_SATURATION, toLevel};
+    _params[CC_TARGET_COLOR_B_VALUE] = {&_colorB.value, DMX_CH_COLOR_B_VALUE, toLevel};
+    _params[CC_TARGET_COLOR_B_WHITE] = {&_colorB.white, DMX_CH_COLOR_B_WHITE, toLevel};
+}
+
+void DMXState::initSlew() {
+    memset(_slew, 0, sizeof(_slew));
+    _slew[DMX_CH_MASTER_BRIGHTNESS].tauMs = DMX_SLEW_BRIGHTNESS_MS;
+    _slew[DMX_CH_ANIMATION_SPEED].tauMs = DMX_SLEW_SPEED_MS;
+    _slew[DMX_CH_ANIMATION_CTRL].tauMs = DMX_SLEW_CTRL_MS;
+
+    _slew[DMX_CH_MASTER_BRIGHTNESS].fine = true;
+    _slew[DMX_CH_ANIMATION_SPEED].fine = true;
+
+    const uint8_t colorBases[2] = {DMX_CH_COLOR_A_HUE, DMX_CH_COLOR_B_HUE};
+    for (uint8_t base : colorBases) {
+        _slew[base].tauMs = DMX_SLEW_HUE_MS;
+        _slew[base].wraps = true;
+        _slew[base].fine = true;
+        _slew[base + 1].tauMs = DMX_SLEW_COLOR_MS;
+        _slew[base + 2].tauMs = DMX_SLEW_COLOR_MS;
+        _slew[base + 3].tauMs = DMX_SLEW_COLOR_MS;
+    }
+}
+
+void DMXState::setParam(uint8_t channel, uint16_t value) {
+    if (channel >= ZONE_CHANNELS || _slew[channel].tauMs == 0) {
+        snapParam(channel, value);
+        return;
+    }
+    _slew[channel].target = value;  // tick() moves the output
+}
+
+void DMXState::snapParam(uint8_t channel, uint16_t value) {
+    if (channel >= ZONE_CHANNELS) {
+        return;
+    }
+    _slew[channel].target = value;
+    _slew[channel].current = value;
+    emitParam(channel, value);
+}
+
+void DMXState::emitParam(uint8_t channel, uint16_t value) {
+    if (_slew[channel].fine) {
+        setChannel(channel, value >> 8);
+        setChannel(channel + DMX_CH_FINE_OFFSET, value & 0xFF);
+    } else {
+        // Coarse only: round, but never past 255
+        setChannel(channel, static_cast<uint8_t>(std::min<uint32_t>((value + 0x80u) >> 8, 255)));
+    }
+}
+
+uint8_t DMXState::outputValue(uint8_t channel) const {
+    return _frame[DMX_START_ADDRESS - 1 + channel];
+}
+
+uint8_t DMXState::outputFine(uint8_t channel) const {
+    return _frame[DMX_START_ADDRESS - 1 + DMX_CH_FINE_OFFSET + channel];
+}
+
+uint16_t DMXState::outputValue16(uint8_t channel) const {
+    return static_cast<uint16_t>((outputValue(channel) << 8) | outputFine(channel));
+}
+
+void DMXState::tick(uint32_t nowMs) {
+    uint32_t dt = nowMs - _lastSlewMs;
+    if (dt < DMX_SLEW_TICK_MS) {
+        return;
+    }
+    _lastSlewMs = nowMs;
+    if (dt > 1000) {
+        dt = 1000;  // After a stall, converge instead of overshooting
+    }
+
+    for (uint8_t ch = 0; ch < ZONE_CHANNELS; ch++) {
+        Slew& slew = _slew[ch];
+        const uint16_t target = slew.target;
+        if (slew.tauMs == 0 || slew.current == target) {
+            continue;
+        }
+
+        // alpha = dt / (tau + dt) in Q16, a stable discrete one-pole
+        const int32_t alpha = static_cast<int32_t>((dt << 16) / (slew.tauMs + dt));
+        int32_t diff = slew.wraps ? static_cast<int16_t>(target - slew.current)
+                                  : static_cast<int32_t>(target) - slew.current;
+        // |diff| * alpha reaches 2^32 after a stall; multiply in 64 bits
+        int32_t step = static_cast<int32_t>((static_cast<int64_t>(diff) * alpha) >> 16);
+        const int32_t snap = slew.fine ? 4 : 64;  // A few LSBs, or a quarter coarse step
+        if (diff > -snap && diff < snap) {
+            step = diff;  // Close enough: land exactly
+        } else if (step == 0) {
+            step = diff > 0 ? 1 : -1;
+        }
+        slew.current = static_cast<uint16_t>(slew.current + step);
+
+        emitParam(ch, slew.current);
+    }
+}
+
+void DMXState::packFrame() {
     // Pack state into DMX channels
-    dmxData[DMX_CH_MASTER_BRIGHTNESS] = _masterBrightness;
-    dmxData[DMX_CH_ANIMATION_MODE] = (uint8_t)_currentMode * 25; // 0-255 range, ~25 per mode
-    dmxData[DMX_CH_ANIMATION_SPEED] = _animationSpeed;
-    dmxData[DMX_CH_ANIMATION_CTRL] = _animationCtrl;
-    dmxData[DMX_CH_STROBE_RATE] = _strobeRate;
-    dmxData[DMX_CH_BLEND_MODE] = _blendMode;
-    dmxData[DMX_CH_MIRROR_MODE] = _mirror;
-    dmxData[DMX_CH_DIRECTION] = _direction;
-    
-    dmxData[DMX_CH_COLOR_A_HUE] = _colorA.hue;
-    dmxData[DMX_CH_COLOR_A_SATURATION] = _colorA.saturation;
-    dmxData[DMX_CH_COLOR_A_VALUE] = _colorA.value;
-    dmxData[DMX_CH_COLOR_A_WHITE] = _colorA.white;
-    
-    dmxData[DMX_CH_COLOR_B_HUE] = _colorB.hue;
-    dmxData[DMX_CH_COLOR_B_SATURATION] = _colorB.saturation;
-    dmxData[DMX_CH_COLOR_B_VALUE] = _colorB.value;
-    dmxData[DMX_CH_COLOR_B_WHITE] = _colorB.white;
+    snapParam(DMX_CH_MASTER_BRIGHTNESS, level16(_masterBrightness));
+    snapParam(DMX_CH_ANIMATION_MODE, level16((uint8_t)_currentMode * 25)); // 0-255 range, ~25 per mode
+    snapParam(DMX_CH_ANIMATION_SPEED, level16(_animationSpeed));
+    snapParam(DMX_CH_ANIMATION_CTRL, level16(_animationCtrl));
+    snapParam(DMX_CH_STROBE_RATE, level16(_strobeRate));
+    snapParam(DMX_CH_BLEND_MODE, level16(_blendMode));
+    snapParam(DMX_CH_MIRROR_MODE, level16(_mirror));
+    snapParam(DMX_CH_DIRECTION, level16(_direction));
+
+    snapParam(DMX_CH_COLOR_A_HUE, level16(_colorA.hue));
+    snapParam(DMX_CH_COLOR_A_SATURATION, level16(_colorA.saturation));
+    snapParam(DMX_CH_COLOR_A_VALUE, level16(_colorA.value));
+    snapParam(DMX_CH_COLOR_A_WHITE, level16(_colorA.white));
+
+    snapParam(DMX_CH_COLOR_B_HUE, level16(_colorB.hue));
+    snapParam(DMX_CH_COLOR_B_SATURATION, level16(_colorB.saturation));
+    snapParam(DMX_CH_COLOR_B_VALUE, level16(_colorB.value));
+    snapParam(DMX_CH_COLOR_B_WHITE, level16(_colorB.white));
 }
 
 LedEngineState DMXState::toLedEngineState() const {
+    // Continuous parameters come from the slewed frame so the local preview
+    // fades exactly like the receivers do.
     LedEngineState state;
-    state.masterBrightness = _masterBrightness;
+    state.masterBrightness = outputValue(DMX_CH_MASTER_BRIGHTNESS);
+    state.masterBrightnessFine = outputFine(DMX_CH_MASTER_BRIGHTNESS);
     state.mode = _currentMode;
-    state.animationSpeed = _animationSpeed;
-    state.animationCtrl = _animationCtrl;
+    state.animationSpeed = outputValue(DMX_CH_ANIMATION_SPEED);
+    state.animationSpeedFine = outputFine(DMX_CH_ANIMATION_SPEED);
+    state.animationCtrl = outputValue(DMX_CH_ANIMATION_CTRL);
     state.strobeRate = _strobeRate;
     state.blendMode = _blendMode;
     state.mirror = decodeMirror(_mirror);
     state.direction = decodeDirection(_direction);
-    state.colorA.fromHSV(_colorA.hue, _colorA.saturation, _colorA.value, _colorA.white);
-    state.colorB.fromHSV(_colorB.hue, _colorB.saturation, _colorB.value, _colorB.white);
+    state.colorA.fromHSV16(outputValue16(DMX_CH_COLOR_A_HUE), outputValue(DMX_CH_COLOR_A_SATURATION),
+                           outputValue(DMX_CH_COLOR_A_VALUE), outputValue(DMX_CH_COLOR_A_WHITE));
+    state.colorB.fromHSV16(outputValue16(DMX_CH_COLOR_B_HUE), outputValue(DMX_CH_COLOR_B_SATURATION),
+                           outputValue(DMX_CH_COLOR_B_VALUE), outputValue(DMX_CH_COLOR_B_WHITE));
     return state;
 }
 
@@ -237,6 +429,7 @@ void DMXState::loadScene(uint8_t sceneIndex) {
     _animationCtrl = scene.animationCtrl;
     _strobeRate = scene.strobeRate;
     _currentScene = sceneIndex;
+    packFrame();
 }
 
 void DMXState::saveCurrentAsScene(uint8_t sceneIndex) {
@@ -309,37 +502,94 @@ void DMXState::initDefaultScenes() {
     }
 }
 
+bool DMXState::getScene(uint16_t index, ScenePreset& out) const {
+    if (index >= MAX_SCENES) {
+        return false;
+    }
+    out = _scenes[index];
+    return true;
+}
+
+bool DMXState::commitScenes(const ScenePreset* scenes) {
+    memcpy(_scenes, scenes, sizeof(_scenes));
+    #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
+    Serial.println("Scene bank replaced");
+    #endif
+    return persistScenes();
+}
+
 bool DMXState::loadScenesFromStorage() {
     if (!_prefsReady) {
         return false;
     }
 
-    size_t expectedSize = sizeof(SceneStorageBlock);
-    size_t storedSize = _preferences.getBytesLength(SCENE_STORAGE_KEY);
-    if (storedSize != expectedSize) {
+    SceneStorageBlock* block = new (std::nothrow) SceneStorageBlock;
+    if (!block) {
         return false;
     }
 
-    SceneStorageBlock block;
-    if (_preferences.getBytes(SCENE_STORAGE_KEY, &block, expectedSize) != expectedSize) {
-        return false;
+    bool found = false;
+    for (uint8_t slot = 0; slot < 2; slot++) {
+        const char* key = SCENE_STORAGE_KEYS[slot];
+        if (_preferences.getBytesLength(key) != sizeof(SceneStorageBlock) ||
+            _preferences.getBytes(key, block, sizeof(SceneStorageBlock)) != sizeof(SceneStorageBlock)) {
+            continue;
+        }
+        if (block->magic != SCENE_STORAGE_MAGIC ||
+            block->crc != crc32(reinterpret_cast<const uint8_t*>(block->presets), sizeof(block->presets))) {
+            continue;  // Torn or stale write; the other slot has the previous bank
+        }
+        if (!found || static_cast<int32_t>(block->generation - _bankGeneration) > 0) {
+            memcpy(_scenes, block->presets, sizeof(_scenes));
+            _bankGeneration = block->generation;
+            _bankSlot = slot;
+            found = true;
+        }
     }
+    delete block;
 
-    if (block.magic != SCENE_STORAGE_MAGIC) {
+    return found || loadLegacyScenes();
+}
+
+bool DMXState::loadLegacyScenes() {
+    if (_preferences.getBytesLength(LEGACY_SCENE_STORAGE_KEY) != sizeof(LegacySceneStorageBlock)) {
         return false;
     }
-
-    memcpy(_scenes, block.presets, sizeof(_scenes));
+    LegacySceneStorageBlock legacy;
+    if (_preferences.getBytes(LEGACY_SCENE_STORAGE_KEY, &legacy, sizeof(legacy)) != sizeof(legacy) ||
+        legacy.magic != SCENE_STORAGE_MAGIC) {
+        return false;
+    }
+    // Carry the old ten scenes over into the bank format
+    memcpy(_scenes, legacy.presets, sizeof(legacy.presets));
+    if (persistScenes()) {
+        _preferences.remove(LEGACY_SCENE_STORAGE_KEY);
+    }
     return true;
 }
 
-void DMXState::persistScenes() {
+bool DMXState::persistScenes() {
     if (!_prefsReady) {
-        return;
+        return false;
     }
 
-    SceneStorageBlock block;
-    block.magic = SCENE_STORAGE_MAGIC;
-    memcpy(block.presets, _scenes, sizeof(_scenes));
-    _preferences.putBytes(SCENE_STORAGE_KEY, &block, sizeof(block));
+    SceneStorageBlock* block = new (std::nothrow) SceneStorageBlock;
+    if (!block) {
+        return false;
+    }
+    block->magic = SCENE_STORAGE_MAGIC;
+    block->generation = _bankGeneration + 1;
+    memcpy(block->presets, _scenes, sizeof(_scenes));
+    block->crc = crc32(reinterpret_cast<const uint8_t*>(block->presets), sizeof(block->presets));
+
+    // Never overwrite the slot holding the newest good bank
+    const uint8_t slot = _bankSlot ^ 1;
+    const bool stored = _preferences.putBytes(SCENE_STORAGE_KEYS[slot], block, sizeof(SceneStorageBlock)) ==
+                        sizeof(SceneStorageBlock);
+    if (stored) {
+        _bankGeneration = block->generation;
+        _bankSlot = slot;
+    }
+    delete block;
+    return stored;
 }
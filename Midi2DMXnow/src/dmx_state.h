@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <Preferences.h>
 #include "config.h"
+#include "cc_map.h"
 #include <LedEngine.h>
 
 using LedEngineLib::AnimationMode;
@@ -39,6 +40,14 @@ struct ScenePreset {
  */
 class DMXState {
 public:
+    // Latency probe: local micros() when the probe CC was read from MIDI
+    // and when it reached the state
+    struct LatencyProbe {
+        uint8_t id = 0;
+        uint32_t readUs = 0;
+        uint32_t appliedUs = 0;
+    };
+
     struct SceneEvent {
         bool triggered = false;
         bool saved = false;
@@ -51,14 +60,33 @@ public:
     
     void begin();
     
-    // MIDI handlers - convert MIDI to internal state
-    void handleGlobalCC(byte controller, byte value);
-    void handleColorCC(uint8_t colorBank, byte controller, byte value);
+    // MIDI handlers - convert MIDI to internal state. Values are 14-bit
+    // (0-16383); 7-bit sources pass MidiProcessor's bit-replicated expansion.
+    // Controllers reach here already resolved to a target by CCMap.
+    void handleParameter(CCTarget target, uint16_t value14);
     SceneEvent handleNoteOn(byte note, byte velocity);
     void handleNoteOff(byte note);
+    // Program n recalls (or in save mode stores) scene n + 1
+    SceneEvent handleProgramChange(byte program);
+    // Records the probe and bumps the version so the next packet carries it
+    void setLatencyProbe(uint8_t id, uint32_t readUs);
+    const LatencyProbe& getLatencyProbe() const { return _probe; }
     
     // Generate DMX frame from current state
     void toDMXFrame(uint8_t* dmxData, uint16_t size);
+
+    // Advances slewed parameters toward their MIDI targets; call every loop,
+    // steps every DMX_SLEW_TICK_MS. Outputs land in the frame.
+    void tick(uint32_t nowMs);
+
+    // Persistent frame, updated in place by the MIDI handlers. The version
+    // increments on every channel change; the dirty bitmap accumulates the
+    // changed channels until clearDirty() is called after a transmit.
+    const uint8_t* getFrame() const { return _frame; }
+    uint32_t getVersion() const { return _version; }
+    bool isChannelDirty(uint16_t channel) const;
+    bool getDirtySpan(uint16_t& first, uint16_t& last) const;
+    void clearDirty();
     
     // Getters for display
     uint8_t getMasterBrightness() const { return _masterBrightness; }
@@ -66,19 +94,58 @@ public:
     uint8_t getAnimationSpeed() const { return _animationSpeed; }
     const HSVColor& getColorA() const { return _colorA; }
     const HSVColor& getColorB() const { return _colorB; }
-    int8_t getCurrentScene() const { return _currentScene; }
+    int16_t getCurrentScene() const { return _currentScene; }
+    bool isTempoSync() const { return _tempoSync; }
+
+    // Scene bank access for bulk transfer. commitScenes() replaces all
+    // MAX_SCENES presets and stores them as one NVS write; returns false
+    // if the bank was applied but could not be persisted.
+    bool getScene(uint16_t index, ScenePreset& out) const;
+    bool commitScenes(const ScenePreset* scenes);
 
     LedEngineLib::LedEngineState toLedEngineState() const;
 
 private:
+    // The bank alternates between two NVS keys: a write goes to the slot
+    // not holding the newest bank, so a reset mid-write leaves the previous
+    // bank intact. Load picks the valid block with the higher generation.
     struct SceneStorageBlock {
         uint32_t magic;
+        uint32_t generation;
+        uint32_t crc;  // Over presets
         ScenePreset presets[MAX_SCENES];
     };
+    // Single-key layout used before bank transfer (10 scenes)
+    struct LegacySceneStorageBlock {
+        uint32_t magic;
+        ScenePreset presets[10];
+    };
 
     static constexpr uint32_t SCENE_STORAGE_MAGIC = 0x4C454453; // 'LEDS'
     static constexpr const char* SCENE_STORAGE_NAMESPACE = "dmxScenes";
-    static constexpr const char* SCENE_STORAGE_KEY = "presets";
+    static constexpr const char* SCENE_STORAGE_KEYS[2] = {"bankA", "bankB"};
+    static constexpr const char* LEGACY_SCENE_STORAGE_KEY = "presets";
+    static constexpr uint16_t DIRTY_WORDS = (DMX_UNIVERSE_SIZE + 31) / 32;
+    static constexpr uint8_t ZONE_CHANNELS = 16;
+
+    // Continuous parameters by CCTarget: the state byte the display reads,
+    // the zone channel and the 14-bit -> 8.8 scaling. Targets without a
+    // slot (mode, tempo sync, save mode) are handled individually.
+    struct ParamSlot {
+        uint8_t* coarse;
+        uint8_t channel;
+        uint16_t (*scale)(uint16_t value14);
+    };
+
+    // One-pole slew per zone channel. Parameters are 16-bit (8.8: coarse
+    // DMX byte + fraction); target is the latest MIDI value.
+    struct Slew {
+        uint16_t current;
+        uint16_t target;
+        uint16_t tauMs;  // 0 = not slewed
+        bool wraps;      // Hue: take the short way round the circle
+        bool fine;       // Emits the fraction on channel + DMX_CH_FINE_OFFSET
+    };
 
     // Current state
     AnimationMode _currentMode;
@@ -92,19 +159,45 @@ private:
     uint8_t _mirror;
     uint8_t _direction;
     bool _sceneSaveMode;
+    bool _tempoSync;
+    LatencyProbe _probe;
+
+    // Wire frame mirroring the state above
+    uint8_t _frame[DMX_UNIVERSE_SIZE];
+    uint32_t _dirty[DIRTY_WORDS];
+    uint32_t _version;
+
+    ParamSlot _params[CC_TARGET_COUNT];
+    Slew _slew[ZONE_CHANNELS];
+    uint32_t _lastSlewMs;
     
     // Scene presets
     ScenePreset _scenes[MAX_SCENES];
-    int8_t _currentScene;
+    int16_t _currentScene;
     Preferences _preferences;
     bool _prefsReady;
+    uint32_t _bankGeneration;
+    uint8_t _bankSlot;  // Key holding the newest bank
     
+    void setChannel(uint16_t channel, uint8_t value);
+    void setParam(uint8_t channel, uint16_t value);   // Slewed if configured
+    void snapParam(uint8_t channel, uint16_t value);  // Jumps, e.g. scenes/blackout
+    void emitParam(uint8_t channel, uint16_t value);
+    uint8_t outputValue(uint8_t channel) const;
+    uint8_t outputFine(uint8_t channel) const;
+    uint16_t outputValue16(uint8_t channel) const;
+    void initParams();
+    void initSlew();
+    void packFrame();
+
     // Scene management
     void loadScene(uint8_t sceneIndex);
     void saveCurrentAsScene(uint8_t sceneIndex);
+    SceneEvent triggerScene(uint8_t sceneIndex);
     void initDefaultScenes();
     bool loadScenesFromStorage();
-    void persistScenes();
+    bool loadLegacyScenes();
+    bool persistScenes();
 };
 
 #endif // DMX_STATE_H
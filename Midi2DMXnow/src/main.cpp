@@ -6,6 +6,9 @@
 #include "config.h"
 #include "dmx_state.h"
 #include "display_handler.h"
+#include "state_sender.h"
+#include "pixel_sender.h"
+#include "tempo_tracker.h"
 
 // Platform-specific MIDI handler
 #if MIDI_VIA_SERIAL
@@ -25,14 +28,14 @@ DMXState dmxState;
 ESPNowDMX espnowDMX;
 ESPNowMeshClock meshClock;
 DisplayHandler displayHandler;
+StateSender stateSender;
+PixelSender pixelSender;
+TempoTracker tempoTracker;
 
 // LED monitoring strip
 LedEngineConfig ledConfig;
 LedEngine* ledEngine = nullptr;
 
-uint8_t dmxFrame[DMX_UNIVERSE_SIZE];
-unsigned long lastDMXSend = 0;
-const uint32_t DMX_SEND_INTERVAL = 33; // ~30Hz DMX refresh rate
 
 // Quick RGBW sweep lets us spot wiring faults before DMX starts
 void playBootRGBWTest() {
@@ -113,6 +116,7 @@ void setup() {
   
   midiHandler.setDMXState(&dmxState);
   midiHandler.setDisplayHandler(&displayHandler);
+  midiHandler.setTempoTracker(&tempoTracker);
   
   // Initialize MeshClock so it owns the ESP-NOW driver and forwards non-clock packets
   meshClock.setUserCallback(ESPNowDMX::forwardPacket);
@@ -128,10 +132,21 @@ void setup() {
       delay(1000);
     }
   }
+
+  if (!stateSender.begin(&espnowDMX, &meshClock)) {
+    #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
+      Serial.println("[ERR] Failed to register ESP-NOW broadcast peer");
+    #endif
+  }
+  pixelSender.begin(&meshClock, LED_COUNT);
   
   #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
     Serial.println("Setup complete - Ready for MIDI");
-    Serial.println("Broadcasting DMX over ESP-NOW");
+    #if DMX_PACKET_MODE == DMX_PACKET_COMPACT
+      Serial.println("Broadcasting compact state packets over ESP-NOW");
+    #else
+      Serial.println("Broadcasting DMX over ESP-NOW");
+    #endif
     Serial.println("MeshClock master mode enabled");
     Serial.printf("LED Monitor: %d LEDs on GPIO%d\n", LED_COUNT, LED_DATA_PIN);
   #endif
@@ -153,35 +168,53 @@ void loop() {
   
   // Handle MIDI input
   midiHandler.update();
+
+  // Fade slewed parameters toward their latest MIDI targets
+  dmxState.tick(millis());
+
+  // Beat grid from MIDI clock, expressed in mesh time for the receivers
+  LeslieProtocol::TempoInfo tempo = tempoTracker.getTempoInfo(micros(), meshClock.meshMillis());
+  stateSender.setTempo(tempo, dmxState.isTempoSync());
+  const DMXState::LatencyProbe& probe = dmxState.getLatencyProbe();
+  stateSender.setLatencyProbe(probe.id, probe.readUs, probe.appliedUs);
   
   // Update LED monitor to visualize current state
   if (ledEngine) {
     LedEngineState state = dmxState.toLedEngineState();
+    state.tempoSync = dmxState.isTempoSync() && tempo.beatPeriodUs != 0;
+    state.beatPeriodUs = tempo.beatPeriodUs;
+    state.beatEpochMs = tempo.beatEpochMs;
+    state.beatIndex = tempo.beatIndex;
     ledEngine->update(meshClock.meshMillis(), state);
     ledEngine->show();
   }
 
   displayHandler.update();
   
-  // Generate and send DMX frame at regular intervals
-  unsigned long now = millis();
-  if (now - lastDMXSend >= DMX_SEND_INTERVAL) {
-    lastDMXSend = now;
-    
-    // Generate DMX frame from current state
-    dmxState.toDMXFrame(dmxFrame, DMX_UNIVERSE_SIZE);
-    
-    // Broadcast DMX via ESP-NOW
-    espnowDMX.sendDMXFrame(dmxFrame, DMX_UNIVERSE_SIZE);
-    
+  // Broadcast state via ESP-NOW (compact packet or full universe). DMXState
+  // keeps the frame up to date; the sender decides whether it goes out now
+  // (new version), later (rate limit) or as an idle keep-alive.
+  if (stateSender.update(dmxState.getFrame(), DMX_UNIVERSE_SIZE, dmxState.getVersion(), millis())) {
+    dmxState.clearDirty();
     #if DEBUG_MODE && !defined(USE_SERIAL_MIDI)
       static int frameCount = 0;
       if (++frameCount % 100 == 0) {
-        Serial.printf("Sent %d DMX frames, Clock: %lu ms\n", 
-                frameCount, meshClock.meshMillis());
+        Serial.printf("Sent %d DMX frames (%lu keep-alive), Clock: %lu ms, Tempo: %.1f BPM\n", 
+                frameCount, stateSender.getKeepAlivesSent(), meshClock.meshMillis(), tempoTracker.getBpm());
+        MidiInputQueue::Stats input = midiHandler.getInputStats();
+        Serial.printf("MIDI in: %lu events, queue %u (peak %u, %lu dropped), latency avg %lu us peak %lu us\n",
+                input.received, input.depth, input.peakDepth, input.overflows,
+                input.avgLatencyUs, input.peakLatencyUs);
+        midiHandler.resetInputPeaks();
       }
     #endif
   }
   
+  #if PIXEL_STREAM_ENABLED
+    if (ledEngine) {
+      pixelSender.update(ledEngine->getPreviewPixels(), ledEngine->getLedCount(), millis());
+    }
+  #endif
+  
   yield();
 }
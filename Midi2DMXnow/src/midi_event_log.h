@@ -0,0 +1,119 @@
+#ifndef MIDI_EVENT_LOG_H
+#define MIDI_EVENT_LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+/**
+ * MidiLogEvent - Compact binary record of one log line. MIDI events keep
+ * their raw bytes; status lines point at a string literal. Text is only
+ * produced by format(), i.e. when the log page is actually drawn.
+ */
+struct MidiLogEvent {
+    enum Type : uint8_t {
+        NONE = 0,
+        CONTROL_CHANGE,
+        NOTE_ON,
+        NOTE_OFF,
+        PROGRAM_CHANGE,
+        LEARNED,
+        STATUS
+    };
+
+    uint32_t timeMs;
+    const char* text;  // STATUS only; must have static storage duration
+    uint8_t type;
+    uint8_t channel;
+    uint8_t data1;
+    uint8_t data2;
+
+    static MidiLogEvent midi(Type type, uint8_t channel, uint8_t data1, uint8_t data2) {
+        MidiLogEvent event = {static_cast<uint32_t>(millis()), nullptr, type, channel, data1, data2};
+        return event;
+    }
+
+    static MidiLogEvent status(const char* text) {
+        MidiLogEvent event = {static_cast<uint32_t>(millis()), text, STATUS, 0, 0, 0};
+        return event;
+    }
+
+    void format(char* buffer, size_t size) const {
+        switch (type) {
+            case CONTROL_CHANGE:
+                snprintf(buffer, size, "CC%d=%d", data1, data2);
+                break;
+            case NOTE_ON:
+                snprintf(buffer, size, "Note %d ON", data1);
+                break;
+            case NOTE_OFF:
+                snprintf(buffer, size, "Note %d OFF", data1);
+                break;
+            case PROGRAM_CHANGE:
+                snprintf(buffer, size, "PC %d", data1);
+                break;
+            case LEARNED:
+                // data2: parameter the CC drove before and no longer does
+                if (data2) {
+                    snprintf(buffer, size, "Learned CC%d, #%d unset", data1, data2);
+                } else {
+                    snprintf(buffer, size, "Learned CC%d", data1);
+                }
+                break;
+            case STATUS:
+                snprintf(buffer, size, "%s", text ? text : "");
+                break;
+            default:
+                buffer[0] = '\0';
+                break;
+        }
+    }
+};
+
+/**
+ * MidiEventLog - Lock-free single-producer/single-consumer ring of
+ * MidiLogEvent records. The MIDI path pushes (a struct copy and one atomic
+ * store, never blocks); the display drains it at its own pace. When the
+ * display falls behind, new events are dropped and counted rather than
+ * overwriting records the consumer may be reading.
+ */
+class MidiEventLog {
+public:
+    static constexpr uint16_t CAPACITY = MIDI_EVENT_LOG_SIZE;
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "MIDI_EVENT_LOG_SIZE must be a power of two");
+
+    MidiEventLog() : _head(0), _tail(0), _dropped(0) {}
+
+    // Producer side (MIDI processing)
+    bool push(const MidiLogEvent& event) {
+        uint16_t head = _head.load(std::memory_order_relaxed);
+        if (static_cast<uint16_t>(head - _tail.load(std::memory_order_acquire)) >= CAPACITY) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _events[head & (CAPACITY - 1)] = event;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side (display)
+    bool pop(MidiLogEvent& event) {
+        uint16_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        event = _events[tail & (CAPACITY - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t getDropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    MidiLogEvent _events[CAPACITY];
+    std::atomic<uint16_t> _head;
+    std::atomic<uint16_t> _tail;
+    std::atomic<uint32_t> _dropped;
+};
+
+#endif // MIDI_EVENT_LOG_H
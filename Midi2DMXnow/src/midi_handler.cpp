@@ -13,6 +13,15 @@ void MIDIHandler::begin() {
     
     _midi.begin();
     USB.begin();
+    _processor.begin();
+    _input.begin();
+    _processor.setSysExReply(MIDIHandler::sendSysEx, this);
+#if MIDI_INPUT_TASK
+    if (!_input.startTask(MIDIHandler::pollTrampoline, this)) {
+        _processor.postStatusMessage("MIDI task failed");
+        return;
+    }
+#endif
     _processor.postStatusMessage("MIDI Ready");
 }
 
@@ -24,29 +33,85 @@ void MIDIHandler::setDisplayHandler(DisplayHandler* display) {
     _processor.setDisplayHandler(display);
 }
 
+void MIDIHandler::setTempoTracker(TempoTracker* tracker) {
+    _processor.setTempoTracker(tracker);
+}
+
 void MIDIHandler::update() {
+#if !MIDI_INPUT_TASK
+    poll();
+#endif
+    MidiInputEvent event;
+    while (_input.pop(event)) {
+        _processor.handleEvent(event);
+        _input.markApplied(event, micros());
+    }
+    SysExMessage message;
+    while (_input.popSysEx(message)) {
+        _processor.handleSysEx(message.data, message.length);
+    }
+    _processor.update();
+}
+
+void MIDIHandler::pollTrampoline(void* context) {
+    static_cast<MIDIHandler*>(context)->poll();
+}
+
+void MIDIHandler::poll() {
     midiEventPacket_t packet;
     
     while (_midi.readPacket(&packet)) {
         uint8_t cin = packet.header & 0x0F;
-        byte channel = (packet.byte1 & 0x0F) + 1;
         
         switch (cin) {
+            case 0x08: // Note Off
+            case 0x09: // Note On
             case 0x0B: // Control Change
-                _processor.handleControlChange(channel, packet.byte2, packet.byte3);
+            case 0x0C: // Program Change
+                _input.push({static_cast<uint32_t>(micros()), packet.byte1, packet.byte2, packet.byte3});
                 break;
-                
-            case 0x09: // Note On
-                if (packet.byte3 > 0) {
-                    _processor.handleNoteOn(channel, packet.byte2, packet.byte3);
-                } else {
-                    _processor.handleNoteOff(channel, packet.byte2, 0);
-                }
+
+            case 0x04: // SysEx start or continue
+            case 0x07: // SysEx ends with three bytes
+                feedSysEx(&packet.byte1, 3);
                 break;
-                
-            case 0x08: // Note Off
-                _processor.handleNoteOff(channel, packet.byte2, packet.byte3);
+            case 0x05: // SysEx ends with one byte (or system common)
+                feedSysEx(&packet.byte1, 1);
+                break;
+            case 0x06: // SysEx ends with two bytes
+                feedSysEx(&packet.byte1, 2);
+                break;
+
+            case 0x0F: // Single byte: system real-time
+                if (packet.byte1 >= 0xF8) {
+                    _input.push({static_cast<uint32_t>(micros()), packet.byte1, 0, 0});
+                }
                 break;
         }
     }
 }
+
+void MIDIHandler::feedSysEx(const uint8_t* bytes, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (_sysex.feed(bytes[i])) {
+            _input.pushSysEx(_sysex.data(), _sysex.length(), static_cast<uint32_t>(micros()));
+        }
+    }
+}
+
+void MIDIHandler::sendSysEx(const uint8_t* data, size_t length, void* context) {
+    MIDIHandler* self = static_cast<MIDIHandler*>(context);
+    midiEventPacket_t packet;
+    size_t offset = 0;
+    while (offset < length) {
+        const size_t remaining = length - offset;
+        const uint8_t count = remaining > 3 ? 3 : static_cast<uint8_t>(remaining);
+        // CIN 0x4 while more follows, else 0x5/0x6/0x7 by bytes in the last packet
+        packet.header = (remaining > 3) ? 0x04 : static_cast<uint8_t>(0x04 + count);
+        packet.byte1 = data[offset];
+        packet.byte2 = count > 1 ? data[offset + 1] : 0;
+        packet.byte3 = count > 2 ? data[offset + 2] : 0;
+        self->_midi.writePacket(&packet);
+        offset += count;
+    }
+}
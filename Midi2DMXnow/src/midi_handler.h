@@ -14,19 +14,33 @@ public:
     MIDIHandler();
     
     void begin();
+    // Applies queued MIDI events (and polls USB itself without MIDI_INPUT_TASK)
     void update();
     
     // Set references to other components
     void setDMXState(DMXState* state);
     void setDisplayHandler(DisplayHandler* display);
+    void setTempoTracker(TempoTracker* tracker);
     
     // Get last received message info for display
     const char* getLastMessage() const { return _processor.getLastMessage(); }
     unsigned long getLastMessageTime() const { return _processor.getLastMessageTime(); }
 
+    MidiInputQueue::Stats getInputStats() const { return _input.getStats(); }
+    void resetInputPeaks() { _input.resetPeaks(); }
+
 private:
     USBMIDI _midi;
     MidiProcessor _processor;
+    MidiInputQueue _input;
+    SysExAssembler _sysex;  // Input task only
+
+    // Input side: USB packets -> timestamped events
+    void poll();
+    static void pollTrampoline(void* context);
+    void feedSysEx(const uint8_t* bytes, uint8_t count);
+    // SysEx replies go back out as USB MIDI packets
+    static void sendSysEx(const uint8_t* data, size_t length, void* context);
 };
 
 #endif // MIDI_HANDLER_H
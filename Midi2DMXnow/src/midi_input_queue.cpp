@@ -0,0 +1,131 @@
+#include "midi_input_queue.h"
+
+MidiInputQueue::MidiInputQueue()
+    : _queue(nullptr)
+    , _sysexQueue(nullptr)
+    , _task(nullptr)
+    , _poll(nullptr)
+    , _pollContext(nullptr)
+    , _received(0)
+    , _overflows(0)
+    , _sysexOverflows(0)
+    , _applied(0)
+    , _peakDepth(0)
+    , _avgLatencyUs(0)
+    , _peakLatencyUs(0) {
+}
+
+bool MidiInputQueue::begin() {
+    if (!_queue) {
+        _queue = xQueueCreate(MIDI_INPUT_QUEUE_SIZE, sizeof(MidiInputEvent));
+    }
+    if (!_sysexQueue) {
+        _sysexQueue = xQueueCreate(MIDI_SYSEX_QUEUE_SIZE, sizeof(SysExMessage));
+    }
+    return _queue != nullptr && _sysexQueue != nullptr;
+}
+
+bool MidiInputQueue::startTask(PollFunction poll, void* context) {
+    if (_task || !_queue) {
+        return _task != nullptr;
+    }
+    _poll = poll;
+    _pollContext = context;
+
+    // Above loop() on the application core but below the LED render task,
+    // which must not miss its frame deadline
+    constexpr UBaseType_t kInputPriority = configMAX_PRIORITIES - 3;
+    const BaseType_t created = xTaskCreatePinnedToCore(
+        MidiInputQueue::taskEntry,
+        "MIDIInput",
+        4096,
+        this,
+        kInputPriority,
+        &_task,
+        1);
+    if (created != pdPASS) {
+        _task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void MidiInputQueue::taskEntry(void* param) {
+    MidiInputQueue* self = static_cast<MidiInputQueue*>(param);
+    const TickType_t period = pdMS_TO_TICKS(MIDI_INPUT_POLL_MS) > 0 ? pdMS_TO_TICKS(MIDI_INPUT_POLL_MS) : 1;
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        self->_poll(self->_pollContext);
+        vTaskDelayUntil(&lastWake, period);
+    }
+}
+
+bool MidiInputQueue::push(const MidiInputEvent& event) {
+    if (!_queue) {
+        return false;
+    }
+    if (xQueueSend(_queue, &event, 0) != pdTRUE) {
+        _overflows = _overflows + 1;
+        return false;
+    }
+    _received = _received + 1;
+    return true;
+}
+
+bool MidiInputQueue::pop(MidiInputEvent& event) {
+    if (!_queue) {
+        return false;
+    }
+    const uint16_t depth = static_cast<uint16_t>(uxQueueMessagesWaiting(_queue));
+    if (depth > _peakDepth) {
+        _peakDepth = depth;
+    }
+    return xQueueReceive(_queue, &event, 0) == pdTRUE;
+}
+
+bool MidiInputQueue::pushSysEx(const uint8_t* data, uint8_t length, uint32_t timeUs) {
+    if (!_sysexQueue || length > MIDI_SYSEX_MAX_BYTES) {
+        return false;
+    }
+    SysExMessage message;
+    message.timeUs = timeUs;
+    message.length = length;
+    memcpy(message.data, data, length);
+    if (xQueueSend(_sysexQueue, &message, 0) != pdTRUE) {
+        _sysexOverflows = _sysexOverflows + 1;
+        return false;
+    }
+    return true;
+}
+
+bool MidiInputQueue::popSysEx(SysExMessage& message) {
+    return _sysexQueue && xQueueReceive(_sysexQueue, &message, 0) == pdTRUE;
+}
+
+void MidiInputQueue::markApplied(const MidiInputEvent& event, uint32_t nowUs) {
+    const uint32_t latency = nowUs - event.timeUs;
+    _applied++;
+    if (latency > _peakLatencyUs) {
+        _peakLatencyUs = latency;
+    }
+    // Moving average, 1/16 weight per event
+    _avgLatencyUs = (_applied == 1) ? latency : _avgLatencyUs - (_avgLatencyUs >> 4) + (latency >> 4);
+}
+
+MidiInputQueue::Stats MidiInputQueue::getStats() const {
+    Stats stats;
+    stats.received = _received;
+    stats.applied = _applied;
+    stats.overflows = _overflows;
+    stats.sysexOverflows = _sysexOverflows;
+    stats.depth = _queue ? static_cast<uint16_t>(uxQueueMessagesWaiting(_queue)) : 0;
+    stats.peakDepth = _peakDepth;
+    stats.avgLatencyUs = _avgLatencyUs;
+    stats.peakLatencyUs = _peakLatencyUs;
+    return stats;
+}
+
+void MidiInputQueue::resetPeaks() {
+    _peakDepth = 0;
+    _peakLatencyUs = 0;
+}
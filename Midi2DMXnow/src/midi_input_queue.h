@@ -0,0 +1,94 @@
+#ifndef MIDI_INPUT_QUEUE_H
+#define MIDI_INPUT_QUEUE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "midi_stream_parser.h"
+
+/**
+ * MidiInputEvent - One complete channel voice or real-time message,
+ * stamped with micros() when it was read from USB or the UART
+ */
+struct MidiInputEvent {
+    uint32_t timeUs;
+    uint8_t status;  // Including channel; 0xF8-0xFF for real-time
+    uint8_t data1;
+    uint8_t data2;
+};
+
+/**
+ * SysExMessage - One complete System Exclusive message, F0..F7 inclusive
+ */
+struct SysExMessage {
+    uint32_t timeUs;
+    uint8_t length;
+    uint8_t data[MIDI_SYSEX_MAX_BYTES];
+};
+
+/**
+ * MidiInputQueue - Decouples MIDI reception from loop(). A dedicated task
+ * polls the transport every MIDI_INPUT_POLL_MS and pushes timestamped
+ * events; loop() pops them and applies them to the state. A slow display
+ * redraw then delays when an event is applied, but not when it was read,
+ * and the stamps keep MIDI clock timing intact.
+ *
+ * With MIDI_INPUT_TASK=0 no task is started and the owner polls from
+ * loop() itself; the queue works the same either way.
+ */
+class MidiInputQueue {
+public:
+    struct Stats {
+        uint32_t received;
+        uint32_t applied;
+        uint32_t overflows;     // Dropped because the queue was full
+        uint32_t sysexOverflows;
+        uint16_t depth;         // Events waiting right now
+        uint16_t peakDepth;
+        uint32_t avgLatencyUs;  // Read-to-apply, smoothed over ~16 events
+        uint32_t peakLatencyUs;
+    };
+
+    typedef void (*PollFunction)(void* context);
+
+    MidiInputQueue();
+
+    bool begin();
+    // Runs poll(context) from the input task until reboot
+    bool startTask(PollFunction poll, void* context);
+
+    // Input task side; never blocks, drops and counts when full
+    bool push(const MidiInputEvent& event);
+    // loop() side
+    bool pop(MidiInputEvent& event);
+    // Complete SysEx messages travel in a separate, shallow queue
+    bool pushSysEx(const uint8_t* data, uint8_t length, uint32_t timeUs);
+    bool popSysEx(SysExMessage& message);
+    void markApplied(const MidiInputEvent& event, uint32_t nowUs);
+
+    Stats getStats() const;
+    void resetPeaks();
+
+private:
+    QueueHandle_t _queue;
+    QueueHandle_t _sysexQueue;
+    TaskHandle_t _task;
+    PollFunction _poll;
+    void* _pollContext;
+
+    // Written by the input task only
+    volatile uint32_t _received;
+    volatile uint32_t _overflows;
+    volatile uint32_t _sysexOverflows;
+    // Written by loop() only
+    uint32_t _applied;
+    uint16_t _peakDepth;
+    uint32_t _avgLatencyUs;
+    uint32_t _peakLatencyUs;
+
+    static void taskEntry(void* param);
+};
+
+#endif // MIDI_INPUT_QUEUE_H
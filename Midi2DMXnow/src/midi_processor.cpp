@@ -1,44 +1,264 @@
 #include "midi_processor.h"
 
+namespace {
+
+constexpr uint8_t CC_DATA_ENTRY_MSB = 6;
+constexpr uint8_t CC_DATA_ENTRY_LSB = 38;
+constexpr uint8_t CC_NRPN_LSB = 98;
+constexpr uint8_t CC_NRPN_MSB = 99;
+constexpr uint8_t CC_RPN_LSB = 100;
+constexpr uint8_t CC_RPN_MSB = 101;
+constexpr uint8_t NRPN_NULL = 0x7F;
+
+// A lone 7-bit value spans the full 14-bit range (127 -> 16383)
+uint16_t expand7(uint8_t value) {
+    return static_cast<uint16_t>((value << 7) | value);
+}
+
+}
+
 MidiProcessor::MidiProcessor()
     : _dmxState(nullptr)
     , _displayHandler(nullptr)
-    , _lastMessageTime(0) {
+    , _tempoTracker(nullptr)
+    , _sysex()
+    , _ccMap()
+    , _lastEvent()
+    , _ccPaired(0)
+    , _nrpnMsb(NRPN_NULL)
+    , _nrpnLsb(NRPN_NULL)
+    , _nrpnDataMsb(0)
+    , _nrpnPaired(false)
+    , _nrpnLastMs(0) {
     _lastMessage[0] = '\0';
+    memset(_ccMsb, 0, sizeof(_ccMsb));
+}
+
+void MidiProcessor::begin() {
+    _ccMap.begin();
 }
 
 void MidiProcessor::setDMXState(DMXState* state) {
     _dmxState = state;
+    _sysex.setDMXState(state);
 }
 
 void MidiProcessor::setDisplayHandler(DisplayHandler* display) {
     _displayHandler = display;
 }
 
+void MidiProcessor::setTempoTracker(TempoTracker* tracker) {
+    _tempoTracker = tracker;
+}
+
+void MidiProcessor::setSysExReply(SceneSysEx::ReplyFunction reply, void* context) {
+    _sysex.setReply(reply, context);
+}
+
+void MidiProcessor::update() {
+    if (_sysex.isReceiving()) {
+        _sysex.update(millis());
+        if (!_sysex.isReceiving()) {
+            logEvent(MidiLogEvent::status("Bank timeout"));
+        }
+    }
+}
+
+void MidiProcessor::handleEvent(const MidiInputEvent& event) {
+    if (event.status >= 0xF8) {
+        handleRealtime(event.status, event.timeUs);
+        return;
+    }
+    const uint8_t channel = (event.status & 0x0F) + 1;
+    if ((event.status & 0xF0) == 0xB0 && event.data1 == CC_LATENCY_PROBE) {
+        // Keeps the time the probe was read rather than applied
+        handleProbe(channel, event.data2, event.timeUs);
+        return;
+    }
+    switch (event.status & 0xF0) {
+        case 0x80:
+            handleNoteOff(channel, event.data1, event.data2);
+            break;
+        case 0x90:
+            if (event.data2 > 0) {
+                handleNoteOn(channel, event.data1, event.data2);
+            } else {
+                handleNoteOff(channel, event.data1, 0);
+            }
+            break;
+        case 0xB0:
+            handleControlChange(channel, event.data1, event.data2);
+            break;
+        case 0xC0:
+            handleProgramChange(channel, event.data1);
+            break;
+        default:
+            break;
+    }
+}
+
+void MidiProcessor::handleRealtime(uint8_t status, uint32_t nowUs) {
+    if (!_tempoTracker) {
+        return;
+    }
+    // Clock runs at 24 ppqn, so it is never logged
+    switch (status) {
+        case 0xF8:
+            _tempoTracker->onClock(nowUs);
+            break;
+        case 0xFA:
+            _tempoTracker->onStart();
+            logEvent(MidiLogEvent::status("Clock Start"));
+            break;
+        case 0xFC:
+            _tempoTracker->onStop();
+            logEvent(MidiLogEvent::status("Clock Stop"));
+            break;
+        default:
+            break;  // Continue keeps the beat count; sensing/reset ignored
+    }
+}
+
 void MidiProcessor::handleControlChange(uint8_t channel, uint8_t controller, uint8_t value) {
     if (!_dmxState) {
         return;
     }
 
-    char msg[32];
-    snprintf(msg, sizeof(msg), "CC%d=%d", controller, value);
-    logMessage(msg);
+    if (controller == CC_LATENCY_PROBE) {
+        handleProbe(channel, value, micros());
+        return;
+    }
+
+    logEvent(MidiLogEvent::midi(MidiLogEvent::CONTROL_CHANGE, channel, controller, value));
 
     if (!isActiveChannel(channel)) {
         return;
     }
 
-    if (controller >= CC_COLOR_A_HUE && controller <= CC_COLOR_A_WHITE) {
-        _dmxState->handleColorCC(0, controller, value);
+    if (controller == CC_MIDI_LEARN) {
+        handleLearn(value);
+        return;
+    }
+    // Data entry and parameter selection stay NRPN, never learned
+    CCTarget replaced = CC_TARGET_NONE;
+    if (!isParameterController(controller) && _ccMap.learn(controller, millis(), &replaced)) {
+        logEvent(MidiLogEvent::midi(MidiLogEvent::LEARNED, channel, controller, replaced));
+    }
+
+#if MIDI_HIRES_CC
+    if (handleNrpn(controller, value)) {
         return;
     }
+    if (isFineController(controller)) {
+        const uint8_t msbController = controller - 32;
+        _ccPaired |= 1UL << msbController;
+        dispatchControl(msbController, static_cast<uint16_t>((_ccMsb[msbController] << 7) | value));
+        return;
+    }
+    if (controller < 32) {
+        _ccMsb[controller] = value;
+        // A paired controller follows with its LSB; expanding the MSB
+        // here would overshoot and step back on every coarse change
+        if (_ccPaired & (1UL << controller)) {
+            dispatchControl(controller, static_cast<uint16_t>(value << 7));
+            return;
+        }
+    }
+#endif
+
+    dispatchControl(controller, expand7(value));
+}
+
+void MidiProcessor::handleProbe(uint8_t channel, uint8_t id, uint32_t readUs) {
+    // Probes may run at tens per second, so they stay out of the log
+    if (_dmxState && id != 0 && isActiveChannel(channel)) {
+        _dmxState->setLatencyProbe(id, readUs);
+    }
+}
 
-    if (controller >= CC_COLOR_B_HUE && controller <= CC_COLOR_B_WHITE) {
-        _dmxState->handleColorCC(1, controller, value);
+void MidiProcessor::handleLearn(uint8_t value) {
+    if (value == 127) {
+        _ccMap.cancelLearn();
+        _ccMap.resetToDefaults();
+        logEvent(MidiLogEvent::status("CC map reset"));
+        return;
+    }
+    if (value >= CC_TARGET_COUNT) {
         return;
     }
+    const CCTarget target = static_cast<CCTarget>(value);
+    _ccMap.beginLearn(target, millis());
+    logEvent(MidiLogEvent::status(CCMap::learnLabel(target)));
+}
+
+void MidiProcessor::dispatchControl(uint8_t controller, uint16_t value14) {
+    _dmxState->handleParameter(_ccMap.lookup(controller), value14);
+}
+
+// NRPN 0:n writes the parameter mapped to CC n. Returns true if the CC was
+// consumed as parameter selection or data entry.
+bool MidiProcessor::handleNrpn(uint8_t controller, uint8_t value) {
+    const unsigned long now = millis();
+    switch (controller) {
+        case CC_NRPN_MSB:
+            _nrpnMsb = value;
+            _nrpnLastMs = now;
+            return true;
+
+        case CC_NRPN_LSB:
+            _nrpnLsb = value;
+            _nrpnLastMs = now;
+            return true;
+
+        case CC_RPN_MSB:
+        case CC_RPN_LSB:
+            // RPNs aren't supported; selecting one deselects the NRPN
+            _nrpnMsb = NRPN_NULL;
+            _nrpnLsb = NRPN_NULL;
+            return true;
+
+        case CC_DATA_ENTRY_MSB:
+        case CC_DATA_ENTRY_LSB:
+            break;
+
+        default:
+            return false;
+    }
+
+    const bool selected = _nrpnMsb != NRPN_NULL || _nrpnLsb != NRPN_NULL;
+    if (!selected || now - _nrpnLastMs > MIDI_NRPN_TIMEOUT_MS) {
+        return false;  // Plain CC 6 / 38
+    }
+    _nrpnLastMs = now;
+
+    if (_nrpnMsb != 0 || !_ccMap.isMapped(_nrpnLsb)) {
+        return true;  // Unknown parameter: swallow the data entry
+    }
+    if (controller == CC_DATA_ENTRY_MSB) {
+        _nrpnDataMsb = value;
+        dispatchControl(_nrpnLsb, _nrpnPaired ? static_cast<uint16_t>(value << 7) : expand7(value));
+    } else {
+        _nrpnPaired = true;
+        dispatchControl(_nrpnLsb, static_cast<uint16_t>((_nrpnDataMsb << 7) | value));
+    }
+    return true;
+}
+
+bool MidiProcessor::isFineController(uint8_t controller) const {
+#if MIDI_HIRES_CC
+    return controller >= 32 && controller < 64 && !_ccMap.isMapped(controller);
+#else
+    return false;
+#endif
+}
 
-    _dmxState->handleGlobalCC(controller, value);
+bool MidiProcessor::isParameterController(uint8_t controller) {
+#if MIDI_HIRES_CC
+    return controller == CC_DATA_ENTRY_MSB || controller == CC_DATA_ENTRY_LSB ||
+           (controller >= CC_NRPN_LSB && controller <= CC_RPN_MSB);
+#else
+    return false;
+#endif
 }
 
 void MidiProcessor::handleNoteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
@@ -46,14 +266,12 @@ void MidiProcessor::handleNoteOn(uint8_t channel, uint8_t note, uint8_t velocity
         return;
     }
 
-    char msg[32];
-    snprintf(msg, sizeof(msg), "Note %d ON", note);
-    logMessage(msg);
+    logEvent(MidiLogEvent::midi(MidiLogEvent::NOTE_ON, channel, note, velocity));
 
     DMXState::SceneEvent event = _dmxState->handleNoteOn(note, velocity);
     if (_displayHandler && event.triggered) {
         if (event.blackout) {
-            _displayHandler->logMessage("Blackout");
+            logEvent(MidiLogEvent::status("Blackout"));
         } else {
             _displayHandler->showSceneNotification(event.sceneIndex, event.saved);
         }
@@ -67,20 +285,48 @@ void MidiProcessor::handleNoteOff(uint8_t channel, uint8_t note, uint8_t velocit
     _dmxState->handleNoteOff(note);
 }
 
+void MidiProcessor::handleProgramChange(uint8_t channel, uint8_t program) {
+    if (!_dmxState || !isActiveChannel(channel)) {
+        return;
+    }
+
+    logEvent(MidiLogEvent::midi(MidiLogEvent::PROGRAM_CHANGE, channel, program, 0));
+
+    DMXState::SceneEvent event = _dmxState->handleProgramChange(program);
+    if (_displayHandler && event.triggered) {
+        _displayHandler->showSceneNotification(event.sceneIndex, event.saved);
+    }
+}
+
+void MidiProcessor::handleSysEx(const uint8_t* data, uint8_t length) {
+    if (!_dmxState) {
+        return;
+    }
+    const uint16_t committedBefore = _sysex.getCommitCount();
+    if (!_sysex.handleMessage(data, length, millis())) {
+        return;  // Someone else's SysEx
+    }
+    if (_sysex.getCommitCount() != committedBefore) {
+        logEvent(MidiLogEvent::status("Bank loaded"));
+    }
+}
+
 void MidiProcessor::postStatusMessage(const char* message) {
     if (!message) {
         return;
     }
-    logMessage(message);
+    logEvent(MidiLogEvent::status(message));
 }
 
-void MidiProcessor::logMessage(const char* msg) {
-    strncpy(_lastMessage, msg, sizeof(_lastMessage) - 1);
-    _lastMessage[sizeof(_lastMessage) - 1] = '\0';
-    _lastMessageTime = millis();
+const char* MidiProcessor::getLastMessage() const {
+    _lastEvent.format(_lastMessage, sizeof(_lastMessage));
+    return _lastMessage;
+}
 
+void MidiProcessor::logEvent(const MidiLogEvent& event) {
+    _lastEvent = event;
     if (_displayHandler) {
-        _displayHandler->logMessage(msg);
+        _displayHandler->logEvent(event);
     }
 }
 
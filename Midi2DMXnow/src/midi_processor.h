@@ -5,33 +5,76 @@
 #include "config.h"
 #include "dmx_state.h"
 #include "display_handler.h"
+#include "tempo_tracker.h"
+#include "midi_input_queue.h"
+#include "scene_sysex.h"
+#include "cc_map.h"
 
 /**
  * MidiProcessor centralizes MIDI -> DMX/Display routing so different
  * transport handlers (USB, Serial, etc.) can reuse the same business logic.
+ * It also assembles 14-bit values from MSB/LSB CC pairs and NRPN data
+ * entry (MIDI_HIRES_CC); plain 7-bit CCs are expanded to 14 bits.
+ * Controllers are routed through a CCMap, rebindable with MIDI learn.
  */
 class MidiProcessor {
 public:
     MidiProcessor();
 
+    // Loads the stored CC map
+    void begin();
     void setDMXState(DMXState* state);
     void setDisplayHandler(DisplayHandler* display);
+    void setTempoTracker(TempoTracker* tracker);
 
     void handleControlChange(uint8_t channel, uint8_t controller, uint8_t value);
     void handleNoteOn(uint8_t channel, uint8_t note, uint8_t velocity);
     void handleNoteOff(uint8_t channel, uint8_t note, uint8_t velocity);
-    void postStatusMessage(const char* message);
+    void handleProgramChange(uint8_t channel, uint8_t program);
+    // Complete F0..F7 message; scene bank transfer, see SceneSysEx
+    void handleSysEx(const uint8_t* data, uint8_t length);
+    // Transport hook for SysEx replies (dumps and ACKs)
+    void setSysExReply(SceneSysEx::ReplyFunction reply, void* context);
+    // Expires stalled bank uploads; call from loop()
+    void update();
+    // System real-time (0xF8-0xFF): clock, start, continue, stop
+    void handleRealtime(uint8_t status, uint32_t nowUs);
+    // Dispatches a queued event to the handlers above
+    void handleEvent(const MidiInputEvent& event);
+    void postStatusMessage(const char* message);  // message must be a literal/static
 
-    const char* getLastMessage() const { return _lastMessage; }
-    unsigned long getLastMessageTime() const { return _lastMessageTime; }
+    // For transports that batch CCs: LSBs of 14-bit pairs, and NRPN/RPN
+    // select and data entry controllers whose order must be preserved
+    bool isFineController(uint8_t controller) const;
+    static bool isParameterController(uint8_t controller);
+
+    // Formats the last logged event on demand
+    const char* getLastMessage() const;
+    unsigned long getLastMessageTime() const { return _lastEvent.timeMs; }
 
 private:
     DMXState* _dmxState;
     DisplayHandler* _displayHandler;
-    char _lastMessage[32];
-    unsigned long _lastMessageTime;
+    TempoTracker* _tempoTracker;
+    SceneSysEx _sysex;
+    CCMap _ccMap;
+    MidiLogEvent _lastEvent;
+    mutable char _lastMessage[32];
+
+    // 14-bit assembly state (active channel only)
+    uint8_t _ccMsb[32];
+    uint32_t _ccPaired;       // Bit n: CC n has sent its CC n + 32 LSB
+    uint8_t _nrpnMsb;
+    uint8_t _nrpnLsb;
+    uint8_t _nrpnDataMsb;
+    bool _nrpnPaired;         // Data entry LSB (CC 38) seen
+    unsigned long _nrpnLastMs;
 
-    void logMessage(const char* msg);
+    void logEvent(const MidiLogEvent& event);
+    bool handleNrpn(uint8_t controller, uint8_t value);
+    void dispatchControl(uint8_t controller, uint16_t value14);
+    void handleProbe(uint8_t channel, uint8_t id, uint32_t readUs);
+    void handleLearn(uint8_t value);
     bool isActiveChannel(uint8_t channel) const;
 };
 
@@ -0,0 +1,138 @@
+#include "midi_stream_parser.h"
+
+MidiStreamParser::MidiStreamParser()
+    : _message{0, 0, 0}
+    , _runningStatus(0)
+    , _index(1)
+    , _expected(0)
+    , _skip(0)
+    , _partial(false)
+    , _realtime(0)
+    , _dropped(0) {
+}
+
+void MidiStreamParser::reset() {
+    _runningStatus = 0;
+    _index = 1;
+    _expected = 0;
+    _skip = 0;
+    _partial = false;
+    _sysex.abort();
+}
+
+MidiStreamParser::Result MidiStreamParser::feed(uint8_t byte) {
+    // Real-time messages (0xF8-0xFF) may sit between any two bytes and
+    // don't touch running status or a SysEx in progress
+    if (byte >= 0xF8) {
+        _realtime = byte;
+        return RESULT_REALTIME;
+    }
+
+    if (byte & 0x80) {
+        if (byte >= 0xF0) {
+            return handleSystem(byte);
+        }
+        if (_partial || _sysex.isActive()) {
+            _dropped++;  // New status before the previous message completed
+        }
+        _sysex.abort();
+        _skip = 0;
+
+        // Channel voice message
+        _runningStatus = byte;
+        _message[0] = byte;
+        _index = 1;
+        _expected = channelMessageLength(byte);
+        _partial = true;
+        return RESULT_NONE;
+    }
+
+    // Data byte (MSB = 0)
+    if (_sysex.isActive()) {
+        return _sysex.feed(byte) ? RESULT_SYSEX : RESULT_NONE;
+    }
+    if (_skip > 0) {
+        _skip--;
+        return RESULT_NONE;
+    }
+    if (_runningStatus == 0) {
+        _dropped++;  // Data byte without a status to attach to
+        return RESULT_NONE;
+    }
+
+    _message[_index++] = byte;
+    if (_index < _expected) {
+        _partial = true;
+        return RESULT_NONE;
+    }
+    if (_expected == 2) {
+        _message[2] = 0;
+    }
+    // Running status: the next data byte starts another message
+    _index = 1;
+    _partial = false;
+    return RESULT_MESSAGE;
+}
+
+MidiStreamParser::Result MidiStreamParser::handleSystem(uint8_t byte) {
+    if (_partial) {
+        _dropped++;  // Interrupted a partial message
+    }
+    // System exclusive and common messages cancel running status
+    _runningStatus = 0;
+    _index = 1;
+    _expected = 0;
+    _partial = false;
+    _skip = 0;
+
+    switch (byte) {
+        case 0xF0:
+            if (_sysex.isActive()) {
+                _dropped++;  // SysEx without its F7
+            }
+            _sysex.feed(byte);
+            return RESULT_NONE;
+
+        case 0xF7:
+            // Ends a SysEx; a stray one is ignored
+            return _sysex.feed(byte) ? RESULT_SYSEX : RESULT_NONE;
+
+        default:
+            break;
+    }
+
+    if (_sysex.isActive()) {
+        _sysex.abort();
+        _dropped++;
+    }
+    switch (byte) {
+        case 0xF1:  // MTC quarter frame
+        case 0xF3:  // Song select
+            _skip = 1;
+            break;
+        case 0xF2:  // Song position pointer
+            _skip = 2;
+            break;
+        default:    // Tune request, undefined F4/F5
+            break;
+    }
+    return RESULT_NONE;
+}
+
+uint8_t MidiStreamParser::channelMessageLength(uint8_t status) {
+    switch (status & 0xF0) {
+        case 0x80: // Note Off
+        case 0x90: // Note On
+        case 0xA0: // Polyphonic Aftertouch
+        case 0xB0: // Control Change
+        case 0xE0: // Pitch Bend
+            return 3;
+
+        case 0xC0: // Program Change
+        case 0xD0: // Channel Aftertouch
+            return 2;
+
+        default:
+            return 0;
+    }
+}
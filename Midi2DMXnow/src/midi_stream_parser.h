@@ -0,0 +1,113 @@
+#ifndef MIDI_STREAM_PARSER_H
+#define MIDI_STREAM_PARSER_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * SysExAssembler - Streaming F0..F7 collector with a bounded buffer.
+ * Messages longer than MIDI_SYSEX_MAX_BYTES are skipped up to their F7
+ * and counted; a status byte other than real-time aborts the message.
+ */
+class SysExAssembler {
+public:
+    SysExAssembler() : _length(0), _active(false), _overflow(false), _overflows(0) {}
+
+    // Feeds one byte of the stream; returns true when a message completed
+    bool feed(uint8_t byte) {
+        if (byte == 0xF0) {
+            _data[0] = byte;
+            _length = 1;
+            _active = true;
+            _overflow = false;
+            return false;
+        }
+        if (!_active) {
+            return false;
+        }
+        if (byte >= 0xF8) {
+            return false;  // Real-time may interleave; handled elsewhere
+        }
+        if ((byte & 0x80) && byte != 0xF7) {
+            abort();
+            return false;
+        }
+        if (_length >= MIDI_SYSEX_MAX_BYTES) {
+            _overflow = true;
+        } else {
+            _data[_length++] = byte;
+        }
+        if (byte != 0xF7) {
+            return false;
+        }
+        _active = false;
+        if (_overflow) {
+            _overflows++;
+            return false;
+        }
+        return true;
+    }
+
+    void abort() { _active = false; }
+    bool isActive() const { return _active; }
+    const uint8_t* data() const { return _data; }
+    uint8_t length() const { return _length; }
+    uint32_t getOverflows() const { return _overflows; }
+
+private:
+    uint8_t _data[MIDI_SYSEX_MAX_BYTES];
+    uint8_t _length;
+    bool _active;
+    bool _overflow;
+    uint32_t _overflows;
+};
+
+/**
+ * MidiStreamParser - Byte-at-a-time MIDI 1.0 parser for raw serial
+ * streams. Handles running status, real-time bytes between any two bytes
+ * (also inside messages and SysEx), system common messages and SysEx.
+ * A message cut short by a new status byte is dropped and counted, as
+ * are data bytes with no status to attach to.
+ *
+ * Plain C++ without Arduino dependencies, so it builds on the host
+ * against config.h alone.
+ */
+class MidiStreamParser {
+public:
+    enum Result : uint8_t {
+        RESULT_NONE = 0,
+        RESULT_MESSAGE,   // Channel voice message in message()
+        RESULT_REALTIME,  // Single status byte 0xF8-0xFF in realtime()
+        RESULT_SYSEX      // Complete F0..F7 in sysex()
+    };
+
+    MidiStreamParser();
+
+    Result feed(uint8_t byte);
+    void reset();
+
+    // Status (with channel), data1, data2; data2 is 0 for two-byte messages
+    const uint8_t* message() const { return _message; }
+    uint8_t realtime() const { return _realtime; }
+    const SysExAssembler& sysex() const { return _sysex; }
+
+    uint32_t getDroppedCount() const { return _dropped; }
+
+    // Total length including status; 0 for system messages
+    static uint8_t channelMessageLength(uint8_t status);
+
+private:
+    uint8_t _message[3];
+    uint8_t _runningStatus;  // 0 when none applies
+    uint8_t _index;          // Next data byte slot in _message
+    uint8_t _expected;       // Total length of the message being assembled
+    uint8_t _skip;           // System common data bytes still to discard
+    bool _partial;           // Status or data of an incomplete message seen
+    uint8_t _realtime;
+    SysExAssembler _sysex;
+    uint32_t _dropped;
+
+    Result handleSystem(uint8_t byte);
+};
+
+#endif // MIDI_STREAM_PARSER_H
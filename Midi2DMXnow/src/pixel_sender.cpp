@@ -0,0 +1,177 @@
+#include "pixel_sender.h"
+#include <esp_now.h>
+
+using LedEngineLib::PixelEncoder;
+using LeslieProtocol::kPixelChunkBytes;
+
+namespace {
+
+const uint8_t kBroadcastAddress[ESP_NOW_ETH_ALEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+constexpr size_t kEncodedCapacity = static_cast<size_t>(LeslieProtocol::kMaxPixelChunks) * kPixelChunkBytes;
+
+}
+
+PixelSender::PixelSender()
+    : _clock(nullptr)
+    , _previous(nullptr)
+    , _encoded(nullptr)
+    , _maxPixels(0)
+    , _previousCount(0)
+    , _frameId(0)
+    , _framesSinceKey(0)
+    , _sequence(0)
+    , _lastFrameMs(0)
+    , _sending(false)
+    , _sendKeyframe(false)
+    , _sendOk(true)
+    , _sendFrameId(0)
+    , _sendBaseFrameId(0)
+    , _sendPixelCount(0)
+    , _sendLength(0)
+    , _sendOffset(0)
+    , _framesSent(0)
+    , _keyframesSent(0)
+    , _sendErrors(0)
+    , _queueStalls(0)
+    , _encodedBytes(0)
+    , _rawBytes(0) {
+}
+
+PixelSender::~PixelSender() {
+    delete[] _previous;
+    delete[] _encoded;
+}
+
+void PixelSender::begin(ESPNowMeshClock* clock, uint16_t maxPixels) {
+    // The broadcast peer is registered by StateSender::begin()
+    _clock = clock;
+
+    // Even an incompressible keyframe has to fit the chunk budget
+    uint16_t limit = 0;
+    while (limit < maxPixels &&
+           PixelEncoder::maxEncodedSize((limit + 1) * LeslieProtocol::PIXEL_RGB) <= kEncodedCapacity) {
+        ++limit;
+    }
+    _maxPixels = limit;
+
+    if (!_previous) {
+        _previous = new uint8_t[static_cast<size_t>(_maxPixels) * LeslieProtocol::PIXEL_RGB]();
+    }
+    if (!_encoded) {
+        _encoded = new uint8_t[kEncodedCapacity];
+    }
+}
+
+bool PixelSender::update(const LedEngineLib::CRGB* pixels, uint16_t count, uint32_t nowMs) {
+    if (!_sending) {
+        if (!pixels || count == 0 || !_encoded || nowMs - _lastFrameMs < 1000 / PIXEL_STREAM_FPS) {
+            return false;
+        }
+        _lastFrameMs = nowMs;
+        if (!startFrame(pixels, count)) {
+            _sendErrors++;
+            return false;
+        }
+    }
+
+    if (!sendPending()) {
+        return false;  // Rest of the frame goes out on later passes
+    }
+    _sending = false;
+    if (!_sendOk) {
+        _sendErrors++;
+        return false;
+    }
+    _framesSent++;
+    return true;
+}
+
+bool PixelSender::startFrame(const LedEngineLib::CRGB* pixels, uint16_t count) {
+    if (count > _maxPixels) {
+        count = _maxPixels;
+    }
+    static_assert(sizeof(LedEngineLib::CRGB) == 3, "CRGB must be packed r,g,b");
+    const uint8_t* current = reinterpret_cast<const uint8_t*>(pixels);
+    const size_t rawBytes = static_cast<size_t>(count) * LeslieProtocol::PIXEL_RGB;
+
+    // Keyframes bound the recovery time after a lost chunk
+    bool keyframe = _framesSinceKey == 0 || count != _previousCount;
+    size_t encodedBytes = PixelEncoder::encode(current, keyframe ? nullptr : _previous, rawBytes,
+                                               _encoded, kEncodedCapacity);
+    if (encodedBytes == 0) {
+        return false;
+    }
+
+    _sending = true;
+    _sendKeyframe = keyframe;
+    _sendOk = true;
+    _sendBaseFrameId = _frameId - 1;
+    _sendFrameId = _frameId++;
+    _sendPixelCount = count;
+    _sendLength = encodedBytes;
+    _sendOffset = 0;
+
+    // Deltas chain off what was sent, even if the radio dropped it; the
+    // next keyframe resynchronizes any receiver that missed a link
+    memcpy(_previous, current, rawBytes);
+    _previousCount = count;
+    _framesSinceKey = (_framesSinceKey + 1) % PIXEL_KEYFRAME_INTERVAL;
+    if (keyframe) {
+        _keyframesSent++;
+    }
+    _encodedBytes += encodedBytes;
+    _rawBytes += rawBytes;
+    return true;
+}
+
+bool PixelSender::sendPending() {
+    const uint8_t flags = _sendKeyframe ? LeslieProtocol::kFlagKeyframe : 0;
+
+    LeslieProtocol::PixelPacket packet;
+    for (uint8_t queued = 0; _sendOffset < _sendLength; queued++) {
+        if (queued == PIXEL_CHUNKS_PER_PASS) {
+            return false;
+        }
+        uint16_t chunkIndex = _sendOffset / kPixelChunkBytes;
+        uint8_t length = (_sendLength - _sendOffset) < kPixelChunkBytes ? (_sendLength - _sendOffset) : kPixelChunkBytes;
+
+        LeslieProtocol::initHeader(packet.header, LeslieProtocol::PACKET_PIXELS,
+                                   PIXEL_STREAM_UNIVERSE + chunkIndex / LeslieProtocol::kChunksPerUniverse,
+                                   _sequence);
+        packet.header.flags = flags;
+        packet.frameId = _sendFrameId;
+        packet.baseFrameId = _sendKeyframe ? _sendFrameId : _sendBaseFrameId;
+        packet.chunk = chunkIndex % LeslieProtocol::kChunksPerUniverse;
+        packet.length = length;
+        packet.format = LeslieProtocol::PIXEL_RGB;
+        memcpy(packet.data, _encoded + _sendOffset, length);
+
+        if (!sendPacket(&packet, sizeof(packet) - kPixelChunkBytes + length)) {
+            return false;
+        }
+        _sendOffset += length;
+    }
+
+    LeslieProtocol::SyncPacket sync;
+    LeslieProtocol::initHeader(sync.header, LeslieProtocol::PACKET_SYNC, PIXEL_STREAM_UNIVERSE, _sequence);
+    sync.header.flags = flags;
+    sync.frameId = _sendFrameId;
+    sync.format = LeslieProtocol::PIXEL_RGB;
+    sync.pixelCount = _sendPixelCount;
+    sync.encodedBytes = _sendLength;
+    sync.meshTimeMs = _clock ? _clock->meshMillis() : millis();
+    return sendPacket(&sync, sizeof(sync));
+}
+
+bool PixelSender::sendPacket(const void* data, size_t length) {
+    esp_err_t result = esp_now_send(kBroadcastAddress, static_cast<const uint8_t*>(data), length);
+    if (result == ESP_ERR_ESPNOW_NO_MEM) {
+        _queueStalls++;
+        return false;  // TX queue full: retry this packet next pass
+    }
+    _sequence++;
+    if (result != ESP_OK) {
+        _sendOk = false;  // Lost; the receiver drops the incomplete frame
+    }
+    return true;
+}
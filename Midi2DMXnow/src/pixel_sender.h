@@ -0,0 +1,75 @@
+#ifndef PIXEL_SENDER_H
+#define PIXEL_SENDER_H
+
+#include <Arduino.h>
+#include <ESPNowMeshClock.h>
+#include <LedEngine.h>
+#include <LeslieProtocol.h>
+#include <PixelCodec.h>
+#include "config.h"
+
+/**
+ * PixelSender - Streams pixel frames to receivers in direct pixel mode.
+ * Each frame is PixelCodec-encoded (a keyframe every
+ * PIXEL_KEYFRAME_INTERVAL frames, XOR deltas in between), cut into 128-byte
+ * chunks over consecutive universes from PIXEL_STREAM_UNIVERSE and closed
+ * by a sync packet that marks the frame boundary.
+ *
+ * A frame is sent over several loop passes, at most PIXEL_CHUNKS_PER_PASS
+ * chunks each, so large frames don't flood the ESP-NOW TX queue. When the
+ * queue is full anyway the chunk is retried on the next pass; a new frame
+ * is only encoded once the previous one is out.
+ */
+class PixelSender {
+public:
+    PixelSender();
+    ~PixelSender();
+
+    // Allocates the previous-frame and encode buffers for maxPixels
+    void begin(ESPNowMeshClock* clock, uint16_t maxPixels);
+
+    // Queues the next chunks of the frame in flight, or starts a new RGB
+    // frame if PIXEL_STREAM_FPS allows; returns true when a frame completed
+    bool update(const LedEngineLib::CRGB* pixels, uint16_t count, uint32_t nowMs);
+
+    uint32_t getFramesSent() const { return _framesSent; }
+    uint32_t getKeyframesSent() const { return _keyframesSent; }
+    uint32_t getSendErrors() const { return _sendErrors; }
+    uint32_t getQueueStalls() const { return _queueStalls; }
+    uint32_t getEncodedBytes() const { return _encodedBytes; }
+    uint32_t getRawBytes() const { return _rawBytes; }
+
+private:
+    ESPNowMeshClock* _clock;
+    uint8_t* _previous;
+    uint8_t* _encoded;
+    uint16_t _maxPixels;
+    uint16_t _previousCount;
+    uint8_t _frameId;
+    uint16_t _framesSinceKey;
+    uint16_t _sequence;
+    uint32_t _lastFrameMs;
+
+    // Frame in flight
+    bool _sending;
+    bool _sendKeyframe;
+    bool _sendOk;
+    uint8_t _sendFrameId;
+    uint8_t _sendBaseFrameId;
+    uint16_t _sendPixelCount;
+    size_t _sendLength;
+    size_t _sendOffset;
+
+    uint32_t _framesSent;
+    uint32_t _keyframesSent;
+    uint32_t _sendErrors;
+    uint32_t _queueStalls;
+    uint32_t _encodedBytes;
+    uint32_t _rawBytes;
+
+    bool startFrame(const LedEngineLib::CRGB* pixels, uint16_t count);
+    bool sendPending();
+    bool sendPacket(const void* data, size_t length);
+};
+
+#endif // PIXEL_SENDER_H
@@ -0,0 +1,273 @@
+#include "scene_sysex.h"
+#include "dmx_state.h"
+#include <new>
+
+namespace {
+
+// F0, manufacturer, device, command ... checksum, F7
+constexpr uint8_t kHeaderBytes = 4;
+constexpr uint8_t kOverheadBytes = kHeaderBytes + 2;
+
+}
+
+SceneSysEx::SceneSysEx()
+    : _dmxState(nullptr)
+    , _reply(nullptr)
+    , _replyContext(nullptr)
+    , _staging(nullptr)
+    , _first(0)
+    , _count(0)
+    , _received()
+    , _lastActivityMs(0)
+    , _commits(0) {
+}
+
+SceneSysEx::~SceneSysEx() {
+    abortUpload();
+}
+
+void SceneSysEx::setReply(ReplyFunction reply, void* context) {
+    _reply = reply;
+    _replyContext = context;
+}
+
+bool SceneSysEx::handleMessage(const uint8_t* data, uint8_t length, uint32_t nowMs) {
+    if (length < kOverheadBytes || data[0] != 0xF0 || data[length - 1] != 0xF7 ||
+        data[1] != SYSEX_MANUFACTURER_ID || data[2] != SYSEX_DEVICE_ID) {
+        return false;
+    }
+
+    const uint8_t command = data[3];
+    const uint8_t* payload = data + kHeaderBytes;
+    const size_t payloadLength = length - kOverheadBytes;
+
+    if (checksum(data + 3, length - 4) != 0) {
+        sendAck(command, STATUS_CHECKSUM, payloadLength > 0 ? payload[0] : 0);
+        return true;
+    }
+
+    uint8_t first = 0;
+    uint16_t count = 0;
+    switch (command) {
+        case CMD_DUMP_REQUEST:
+            if (!parseRange(payload, payloadLength, first, count)) {
+                sendAck(command, STATUS_FORMAT, 0);
+            } else {
+                sendDump(first, count);
+            }
+            break;
+
+        case CMD_BANK_BEGIN: {
+            Status status = parseRange(payload, payloadLength, first, count)
+                ? beginUpload(first, count, nowMs)
+                : STATUS_FORMAT;
+            sendAck(command, status, first);
+            break;
+        }
+
+        case CMD_BANK_SCENE:
+            sendAck(command, receiveScene(payload, payloadLength, nowMs), payloadLength > 0 ? payload[0] : 0);
+            break;
+
+        case CMD_BANK_END:
+            sendAck(command, payloadLength == 0 ? commitUpload() : STATUS_FORMAT, _first);
+            break;
+
+        default:
+            break;  // Including our own ACKs echoed back
+    }
+    return true;
+}
+
+void SceneSysEx::update(uint32_t nowMs) {
+    if (_staging && nowMs - _lastActivityMs > SYSEX_BANK_TIMEOUT_MS) {
+        abortUpload();
+    }
+}
+
+SceneSysEx::Status SceneSysEx::beginUpload(uint8_t first, uint16_t count, uint32_t nowMs) {
+    if (!_dmxState) {
+        return STATUS_STORAGE;
+    }
+    // A new BANK_BEGIN restarts any transfer in progress
+    if (!_staging) {
+        _staging = new (std::nothrow) ScenePreset[MAX_SCENES];
+        if (!_staging) {
+            return STATUS_STORAGE;
+        }
+    }
+    // Scenes outside the range keep their current contents
+    for (uint16_t i = 0; i < MAX_SCENES; i++) {
+        _dmxState->getScene(i, _staging[i]);
+    }
+    _first = first;
+    _count = count;
+    memset(_received, 0, sizeof(_received));
+    _lastActivityMs = nowMs;
+    return STATUS_OK;
+}
+
+SceneSysEx::Status SceneSysEx::receiveScene(const uint8_t* payload, size_t length, uint32_t nowMs) {
+    if (length != 1 + PACKED_SCENE_BYTES) {
+        return STATUS_FORMAT;
+    }
+    const uint8_t index = payload[0];
+    if (!_staging || index < _first || index >= _first + _count) {
+        return STATUS_SEQUENCE;
+    }
+    uint8_t raw[SCENE_BYTES];
+    if (!unpack7(payload + 1, PACKED_SCENE_BYTES, raw, SCENE_BYTES) || !decodeScene(raw, _staging[index])) {
+        return STATUS_FORMAT;
+    }
+    _received[index / 32] |= 1UL << (index % 32);
+    _lastActivityMs = nowMs;
+    return STATUS_OK;
+}
+
+SceneSysEx::Status SceneSysEx::commitUpload() {
+    if (!_staging) {
+        return STATUS_SEQUENCE;
+    }
+    for (uint16_t i = _first; i < _first + _count; i++) {
+        if (!(_received[i / 32] & (1UL << (i % 32)))) {
+            return STATUS_INCOMPLETE;  // Host may resend the missing scenes
+        }
+    }
+    const bool stored = _dmxState->commitScenes(_staging);
+    _commits++;
+    abortUpload();
+    return stored ? STATUS_OK : STATUS_STORAGE;
+}
+
+void SceneSysEx::abortUpload() {
+    delete[] _staging;
+    _staging = nullptr;
+}
+
+void SceneSysEx::sendDump(uint8_t first, uint16_t count) {
+    if (!_dmxState) {
+        return;
+    }
+    const uint8_t range[3] = {first, static_cast<uint8_t>(count & 0x7F), static_cast<uint8_t>(count >> 7)};
+    sendMessage(CMD_BANK_BEGIN, range, sizeof(range));
+
+    uint8_t payload[1 + PACKED_SCENE_BYTES];
+    uint8_t raw[SCENE_BYTES];
+    for (uint16_t i = first; i < first + count; i++) {
+        ScenePreset scene;
+        _dmxState->getScene(i, scene);
+        encodeScene(scene, raw);
+        payload[0] = static_cast<uint8_t>(i);
+        pack7(raw, SCENE_BYTES, payload + 1);
+        sendMessage(CMD_BANK_SCENE, payload, sizeof(payload));
+    }
+    sendMessage(CMD_BANK_END, nullptr, 0);
+}
+
+void SceneSysEx::sendAck(uint8_t command, Status status, uint8_t index) {
+    const uint8_t payload[3] = {static_cast<uint8_t>(command & 0x7F), status, static_cast<uint8_t>(index & 0x7F)};
+    sendMessage(CMD_ACK, payload, sizeof(payload));
+}
+
+void SceneSysEx::sendMessage(uint8_t command, const uint8_t* payload, size_t length) {
+    if (!_reply || length + kOverheadBytes > MIDI_SYSEX_MAX_BYTES) {
+        return;
+    }
+    uint8_t message[MIDI_SYSEX_MAX_BYTES];
+    message[0] = 0xF0;
+    message[1] = SYSEX_MANUFACTURER_ID;
+    message[2] = SYSEX_DEVICE_ID;
+    message[3] = command;
+    if (length > 0) {
+        memcpy(message + kHeaderBytes, payload, length);
+    }
+    // Checksum byte is zero while summing, then set to the complement
+    message[kHeaderBytes + length] = 0;
+    message[kHeaderBytes + length] = checksum(message + 3, length + 2);
+    message[kHeaderBytes + length + 1] = 0xF7;
+    _reply(message, length + kOverheadBytes, _replyContext);
+}
+
+bool SceneSysEx::parseRange(const uint8_t* payload, size_t length, uint8_t& first, uint16_t& count) {
+    if (length != 3) {
+        return false;
+    }
+    first = payload[0];
+    count = static_cast<uint16_t>(payload[1] | (payload[2] << 7));
+    return count > 0 && first + count <= MAX_SCENES;
+}
+
+size_t SceneSysEx::pack7(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t written = 0;
+    for (size_t group = 0; group < length; group += 7) {
+        const size_t groupLength = (length - group < 7) ? length - group : 7;
+        uint8_t highBits = 0;
+        for (size_t i = 0; i < groupLength; i++) {
+            highBits |= ((in[group + i] >> 7) & 1) << i;
+            out[written + 1 + i] = in[group + i] & 0x7F;
+        }
+        out[written] = highBits;
+        written += groupLength + 1;
+    }
+    return written;
+}
+
+bool SceneSysEx::unpack7(const uint8_t* in, size_t packedLength, uint8_t* out, size_t length) {
+    size_t read = 0;
+    for (size_t group = 0; group < length; group += 7) {
+        const size_t groupLength = (length - group < 7) ? length - group : 7;
+        if (read + groupLength + 1 > packedLength) {
+            return false;
+        }
+        const uint8_t highBits = in[read];
+        for (size_t i = 0; i < groupLength; i++) {
+            out[group + i] = static_cast<uint8_t>(in[read + 1 + i] | (((highBits >> i) & 1) << 7));
+        }
+        read += groupLength + 1;
+    }
+    return read == packedLength;
+}
+
+uint8_t SceneSysEx::checksum(const uint8_t* data, size_t length) {
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += data[i];
+    }
+    return static_cast<uint8_t>(-sum) & 0x7F;
+}
+
+void SceneSysEx::encodeScene(const ScenePreset& scene, uint8_t* out) {
+    out[0] = static_cast<uint8_t>(scene.mode);
+    out[1] = scene.colorA.hue;
+    out[2] = scene.colorA.saturation;
+    out[3] = scene.colorA.value;
+    out[4] = scene.colorA.white;
+    out[5] = scene.colorB.hue;
+    out[6] = scene.colorB.saturation;
+    out[7] = scene.colorB.value;
+    out[8] = scene.colorB.white;
+    out[9] = scene.masterBrightness;
+    out[10] = scene.speed;
+    out[11] = scene.blendMode;
+    out[12] = scene.mirror;
+    out[13] = scene.direction;
+    out[14] = scene.animationCtrl;
+    out[15] = scene.strobeRate;
+}
+
+bool SceneSysEx::decodeScene(const uint8_t* in, ScenePreset& scene) {
+    if (in[0] >= LedEngineLib::ANIM_MODE_COUNT) {
+        return false;
+    }
+    scene.mode = static_cast<AnimationMode>(in[0]);
+    scene.colorA = HSVColor(in[1], in[2], in[3], in[4]);
+    scene.colorB = HSVColor(in[5], in[6], in[7], in[8]);
+    scene.masterBrightness = in[9];
+    scene.speed = in[10];
+    scene.blendMode = in[11];
+    scene.mirror = in[12];
+    scene.direction = in[13];
+    scene.animationCtrl = in[14];
+    scene.strobeRate = in[15];
+    return true;
+}
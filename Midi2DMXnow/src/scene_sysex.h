@@ -0,0 +1,103 @@
+#ifndef SCENE_SYSEX_H
+#define SCENE_SYSEX_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class DMXState;
+struct ScenePreset;
+
+/**
+ * SceneSysEx - Scene bank upload/download over System Exclusive.
+ *
+ * Every message is
+ *   F0 7D 4C <cmd> <payload...> <checksum> F7
+ * where checksum makes (cmd + payload + checksum) & 0x7F == 0. Scenes
+ * travel as 16 bytes (mode, A h/s/v/w, B h/s/v/w, brightness, speed,
+ * blend, mirror, direction, control, strobe) packed 8-to-7: each group of
+ * up to seven bytes is preceded by a byte holding their high bits
+ * (bit n = byte n), so a scene takes 19 data bytes.
+ *
+ *   0x01 DUMP_REQUEST  first, count lo7, count hi7
+ *                      -> reply BANK_BEGIN, BANK_SCENE..., BANK_END
+ *   0x10 BANK_BEGIN    first, count lo7, count hi7   start a transfer
+ *   0x11 BANK_SCENE    index, 19 packed bytes
+ *   0x12 BANK_END                                     commit
+ *   0x7F ACK           acked cmd, status, index
+ *
+ * An upload is staged off to the side and replaces the bank only when
+ * BANK_END arrives with every announced scene received; the stored bank
+ * is then written as a whole (see DMXState::commitScenes). Every upload
+ * message is acknowledged, so a host sends the next one after the ACK.
+ * A dump is itself a valid upload, so a saved .syx file can be replayed.
+ */
+class SceneSysEx {
+public:
+    enum Command : uint8_t {
+        CMD_DUMP_REQUEST = 0x01,
+        CMD_BANK_BEGIN = 0x10,
+        CMD_BANK_SCENE = 0x11,
+        CMD_BANK_END = 0x12,
+        CMD_ACK = 0x7F
+    };
+
+    enum Status : uint8_t {
+        STATUS_OK = 0,
+        STATUS_CHECKSUM = 1,    // Checksum mismatch
+        STATUS_FORMAT = 2,      // Wrong length or out-of-range field
+        STATUS_SEQUENCE = 3,    // Scene outside the transfer / no BANK_BEGIN
+        STATUS_INCOMPLETE = 4,  // BANK_END before every scene arrived
+        STATUS_STORAGE = 5,     // Bank applied but not persisted / no memory
+    };
+
+    static constexpr uint8_t SCENE_BYTES = 16;
+    static constexpr uint8_t PACKED_SCENE_BYTES = 19;
+
+    // Sends one complete message (F0..F7) to the MIDI output
+    typedef void (*ReplyFunction)(const uint8_t* data, size_t length, void* context);
+
+    SceneSysEx();
+    ~SceneSysEx();
+
+    void setDMXState(DMXState* state) { _dmxState = state; }
+    void setReply(ReplyFunction reply, void* context);
+
+    // Complete F0..F7 message; returns false if it is not addressed to us
+    bool handleMessage(const uint8_t* data, uint8_t length, uint32_t nowMs);
+    // Abandons an upload idle for SYSEX_BANK_TIMEOUT_MS
+    void update(uint32_t nowMs);
+
+    bool isReceiving() const { return _staging != nullptr; }
+    // Increments on every upload that replaced the bank
+    uint16_t getCommitCount() const { return _commits; }
+
+    // Codec, public for tooling and host tests
+    static size_t pack7(const uint8_t* in, size_t length, uint8_t* out);
+    static bool unpack7(const uint8_t* in, size_t packedLength, uint8_t* out, size_t length);
+    static uint8_t checksum(const uint8_t* data, size_t length);
+    static void encodeScene(const ScenePreset& scene, uint8_t* out);
+    static bool decodeScene(const uint8_t* in, ScenePreset& scene);
+
+private:
+    DMXState* _dmxState;
+    ReplyFunction _reply;
+    void* _replyContext;
+
+    ScenePreset* _staging;  // Whole bank while an upload is open
+    uint8_t _first;
+    uint16_t _count;
+    uint32_t _received[(MAX_SCENES + 31) / 32];
+    uint32_t _lastActivityMs;
+    uint16_t _commits;
+
+    Status beginUpload(uint8_t first, uint16_t count, uint32_t nowMs);
+    Status receiveScene(const uint8_t* payload, size_t length, uint32_t nowMs);
+    Status commitUpload();
+    void abortUpload();
+    void sendDump(uint8_t first, uint16_t count);
+    void sendAck(uint8_t command, Status status, uint8_t index);
+    void sendMessage(uint8_t command, const uint8_t* payload, size_t length);
+    static bool parseRange(const uint8_t* payload, size_t length, uint8_t& first, uint16_t& count);
+};
+
+#endif // SCENE_SYSEX_H
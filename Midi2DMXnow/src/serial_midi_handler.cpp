@@ -3,9 +3,11 @@
 #define CONNECTION_TIMEOUT_MS 5000
 
 SerialMIDIHandler::SerialMIDIHandler() :
-    bufferIndex(0),
-    expectedBytes(0),
-    runningStatus(0),
+    ringHead(0),
+    ringCount(0),
+    pendingCount(0),
+    messageCount(0),
+    coalescedCount(0),
     ccCallback(nullptr),
     noteOnCallback(nullptr),
     noteOffCallback(nullptr),
@@ -18,6 +20,14 @@ void SerialMIDIHandler::begin() {
     Serial.begin(SERIAL_MIDI_BAUD);
     // Don't print anything - Serial is used for MIDI data only!
     delay(100);
+#endif
+    _processor.begin();
+    _input.begin();
+    _processor.setSysExReply(SerialMIDIHandler::sendSysEx, this);
+#if MIDI_INPUT_TASK
+    if (!_input.startTask(SerialMIDIHandler::pollTrampoline, this)) {
+        _processor.postStatusMessage("MIDI task failed");
+    }
 #endif
 }
 
@@ -25,25 +35,86 @@ void SerialMIDIHandler::setDMXState(DMXState* state) {
     _processor.setDMXState(state);
 }
 
+void SerialMIDIHandler::setTempoTracker(TempoTracker* tracker) {
+    _processor.setTempoTracker(tracker);
+}
+
 void SerialMIDIHandler::setDisplayHandler(DisplayHandler* display) {
     _processor.setDisplayHandler(display);
 }
 
 void SerialMIDIHandler::update() {
-#ifdef USE_SERIAL_MIDI
     // Check connection status
     if (connected && (millis() - lastMessageTime > CONNECTION_TIMEOUT_MS)) {
         connected = false;
     }
-    
-    // Process incoming MIDI bytes
-    while (Serial.available() > 0) {
-        uint8_t byte = Serial.read();
-        processMIDIByte(byte);
+
+#if !MIDI_INPUT_TASK
+    poll();
+#endif
+
+    // Everything queued since the last call is one batch, so a knob sweep
+    // costs one DMXState update per controller
+    MidiInputEvent event;
+    while (_input.pop(event)) {
+        applyEvent(event);
+        _input.markApplied(event, micros());
+    }
+    flushPendingCC();
+
+    SysExMessage message;
+    while (_input.popSysEx(message)) {
+        _processor.handleSysEx(message.data, message.length);
     }
+    _processor.update();
+}
+
+void SerialMIDIHandler::pollTrampoline(void* context) {
+    static_cast<SerialMIDIHandler*>(context)->poll();
+}
+
+void SerialMIDIHandler::poll() {
+#ifdef USE_SERIAL_MIDI
+    // Pull everything the UART holds in bulk and parse it into events
+    fillRing();
+    drainRing();
 #endif
 }
 
+void SerialMIDIHandler::fillRing() {
+#ifdef USE_SERIAL_MIDI
+    while (ringCount < SERIAL_MIDI_RING_SIZE) {
+        int available = Serial.available();
+        if (available <= 0) {
+            break;
+        }
+        // Contiguous free span after the tail
+        uint16_t tail = (ringHead + ringCount) % SERIAL_MIDI_RING_SIZE;
+        uint16_t span = (tail >= ringHead) ? SERIAL_MIDI_RING_SIZE - tail : ringHead - tail;
+        if (span > SERIAL_MIDI_RING_SIZE - ringCount) {
+            span = SERIAL_MIDI_RING_SIZE - ringCount;
+        }
+        if (static_cast<uint16_t>(available) < span) {
+            span = available;
+        }
+        size_t got = Serial.readBytes(ring + tail, span);
+        if (got == 0) {
+            break;
+        }
+        ringCount += got;
+    }
+#endif
+}
+
+void SerialMIDIHandler::drainRing() {
+    while (ringCount > 0) {
+        uint8_t byte = ring[ringHead];
+        ringHead = (ringHead + 1) % SERIAL_MIDI_RING_SIZE;
+        ringCount--;
+        processMIDIByte(byte);
+    }
+}
+
 bool SerialMIDIHandler::isConnected() {
     return connected;
 }
@@ -61,99 +132,148 @@ void SerialMIDIHandler::onNoteOff(void (*callback)(uint8_t, uint8_t, uint8_t)) {
 }
 
 void SerialMIDIHandler::processMIDIByte(uint8_t byte) {
-    // Status byte (MSB = 1)
-    if (byte & 0x80) {
-        // Real-time messages (0xF8-0xFF) - ignore for now
-        if (byte >= 0xF8) {
-            return;
-        }
-        
-        // System messages (0xF0-0xF7) - ignore for now
-        if (byte >= 0xF0) {
-            bufferIndex = 0;
-            expectedBytes = 0;
-            return;
-        }
-        
-        // Channel voice message
-        runningStatus = byte;
-        midiBuffer[0] = byte;
-        bufferIndex = 1;
-        expectedBytes = getMessageLength(byte);
-        return;
-    }
-    
-    // Data byte (MSB = 0)
-    if (expectedBytes > 0) {
-        midiBuffer[bufferIndex++] = byte;
-        
-        if (bufferIndex >= expectedBytes) {
-            processCompleteMessage();
-            // Reset for next message (running status still active)
-            bufferIndex = 1;
-            midiBuffer[0] = runningStatus;
-        }
+    switch (parser.feed(byte)) {
+        case MidiStreamParser::RESULT_MESSAGE:
+            processCompleteMessage(parser.message());
+            break;
+
+        case MidiStreamParser::RESULT_REALTIME:
+            _input.push({static_cast<uint32_t>(micros()), parser.realtime(), 0, 0});
+            break;
+
+        case MidiStreamParser::RESULT_SYSEX:
+            processSysEx(parser.sysex());
+            break;
+
+        default:
+            break;
     }
 }
 
-void SerialMIDIHandler::processCompleteMessage() {
+void SerialMIDIHandler::processSysEx(const SysExAssembler& sysex) {
     lastMessageTime = millis();
     connected = true;
-    
-    uint8_t status = midiBuffer[0] & 0xF0;
-    uint8_t channel = (midiBuffer[0] & 0x0F) + 1; // Convert to 1-based
-    
+    messageCount++;
+    _input.pushSysEx(sysex.data(), sysex.length(), static_cast<uint32_t>(micros()));
+}
+
+void SerialMIDIHandler::sendSysEx(const uint8_t* data, size_t length, void* context) {
+#ifdef USE_SERIAL_MIDI
+    Serial.write(data, length);
+#endif
+}
+
+void SerialMIDIHandler::processCompleteMessage(const uint8_t* message) {
+    lastMessageTime = millis();
+    connected = true;
+    messageCount++;
+
+    switch (message[0] & 0xF0) {
+        case 0x80: // Note Off
+        case 0x90: // Note On
+        case 0xB0: // Control Change
+        case 0xC0: // Program Change
+            _input.push({static_cast<uint32_t>(micros()), message[0], message[1], message[2]});
+            break;
+
+        // Add other message types as needed
+        default:
+            break;
+    }
+}
+
+void SerialMIDIHandler::applyEvent(const MidiInputEvent& event) {
+    const uint8_t status = event.status >= 0xF8 ? event.status : event.status & 0xF0;
+    const uint8_t channel = (event.status & 0x0F) + 1; // Convert to 1-based
+
+    // Notes act on the current state (scene save/recall), so CCs that
+    // arrived before them must land first. NRPN select/data entry is
+    // order-sensitive too and is never coalesced, nor are latency probes
+    // (their read time matters) or MIDI learn (it claims the next CC).
+    // Clock only feeds the tempo tracker and may pass queued CCs.
+    const bool directCC = MidiProcessor::isParameterController(event.data1) ||
+                          event.data1 == CC_LATENCY_PROBE || event.data1 == CC_MIDI_LEARN;
+    if (status == 0xB0 && !directCC) {
+        queueControlChange(channel, event.data1, event.data2);
+        return;
+    }
+    if (status < 0xF8) {
+        flushPendingCC();
+    }
+
     switch (status) {
         case 0x80: // Note Off
-            _processor.handleNoteOff(channel, midiBuffer[1], midiBuffer[2]);
+            _processor.handleEvent(event);
             if (noteOffCallback && channel == MIDI_CHANNEL) {
-                noteOffCallback(channel, midiBuffer[1], midiBuffer[2]);
+                noteOffCallback(channel, event.data1, event.data2);
             }
             break;
             
         case 0x90: // Note On
-            if (midiBuffer[2] == 0) {
-                _processor.handleNoteOff(channel, midiBuffer[1], 0);
+            _processor.handleEvent(event);
+            if (event.data2 == 0) {
                 if (noteOffCallback && channel == MIDI_CHANNEL) {
-                    noteOffCallback(channel, midiBuffer[1], 0);
-                }
-            } else {
-                _processor.handleNoteOn(channel, midiBuffer[1], midiBuffer[2]);
-                if (noteOnCallback && channel == MIDI_CHANNEL) {
-                    noteOnCallback(channel, midiBuffer[1], midiBuffer[2]);
+                    noteOffCallback(channel, event.data1, 0);
                 }
+            } else if (noteOnCallback && channel == MIDI_CHANNEL) {
+                noteOnCallback(channel, event.data1, event.data2);
             }
             break;
             
-        case 0xB0: // Control Change
-            _processor.handleControlChange(channel, midiBuffer[1], midiBuffer[2]);
+        case 0xB0: // Parameter-number / data-entry Control Change, probe
+            _processor.handleEvent(event);
             if (ccCallback) {
-                ccCallback(channel, midiBuffer[1], midiBuffer[2]);
+                ccCallback(channel, event.data1, event.data2);
             }
             break;
-            
-        // Add other message types as needed
-        default:
+
+        case 0xC0: // Program Change (scene recall)
+            _processor.handleEvent(event);
+            break;
+
+        default: // Real-time
+            _processor.handleEvent(event);
             break;
     }
 }
 
-uint8_t SerialMIDIHandler::getMessageLength(uint8_t status) {
-    status = status & 0xF0;
-    
-    switch (status) {
-        case 0x80: // Note Off
-        case 0x90: // Note On
-        case 0xA0: // Polyphonic Aftertouch
-        case 0xB0: // Control Change
-        case 0xE0: // Pitch Bend
-            return 3;
-            
-        case 0xC0: // Program Change
-        case 0xD0: // Channel Aftertouch
-            return 2;
-            
-        default:
-            return 0;
+void SerialMIDIHandler::queueControlChange(uint8_t channel, uint8_t controller, uint8_t value) {
+    // A new MSB resets its 14-bit pair, so a queued LSB from before it is stale
+    if (controller < 32 && _processor.isFineController(controller + 32)) {
+        for (uint8_t i = 0; i < pendingCount; i++) {
+            if (pendingCC[i].channel == channel && pendingCC[i].controller == controller + 32) {
+                memmove(&pendingCC[i], &pendingCC[i + 1], (pendingCount - i - 1) * sizeof(PendingCC));
+                pendingCount--;
+                coalescedCount++;
+                break;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < pendingCount; i++) {
+        if (pendingCC[i].channel == channel && pendingCC[i].controller == controller) {
+            pendingCC[i].value = value;
+            coalescedCount++;
+            return;
+        }
+    }
+    if (pendingCount >= SERIAL_MIDI_MAX_PENDING_CC) {
+        flushPendingCC();
+    }
+    pendingCC[pendingCount++] = {channel, controller, value};
+}
+
+void SerialMIDIHandler::flushPendingCC() {
+    for (uint8_t i = 0; i < pendingCount; i++) {
+        const PendingCC& cc = pendingCC[i];
+        deliverControlChange(cc.channel, cc.controller, cc.value);
+    }
+    pendingCount = 0;
+}
+
+void SerialMIDIHandler::deliverControlChange(uint8_t channel, uint8_t controller, uint8_t value) {
+    _processor.handleControlChange(channel, controller, value);
+    if (ccCallback) {
+        ccCallback(channel, controller, value);
     }
 }
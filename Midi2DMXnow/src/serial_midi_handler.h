@@ -24,7 +24,8 @@ public:
     void begin();
     
     /**
-     * Process incoming MIDI messages from Serial
+     * Apply MIDI messages queued by the input task (or, without
+     * MIDI_INPUT_TASK, read them from Serial first)
      * Call this regularly in the main loop
      */
     void update();
@@ -39,6 +40,11 @@ public:
      */
     void setDMXState(DMXState* state);
 
+    /**
+     * Set tempo tracker fed by MIDI clock (0xF8) and Start/Stop
+     */
+    void setTempoTracker(TempoTracker* tracker);
+
     /**
      * Set display handler for logging and notifications
      */
@@ -62,14 +68,45 @@ public:
      */
     void onNoteOff(void (*callback)(uint8_t channel, uint8_t note, uint8_t velocity));
 
+    /**
+     * Ingest statistics: complete messages parsed, CCs replaced by a later
+     * value for the same controller within one batch, and bytes discarded
+     * as malformed
+     */
+    uint32_t getMessageCount() const { return messageCount; }
+    uint32_t getCoalescedCount() const { return coalescedCount; }
+    uint32_t getDroppedCount() const { return parser.getDroppedCount(); }
+
+    /**
+     * Input task queue depth and read-to-apply latency
+     */
+    MidiInputQueue::Stats getInputStats() const { return _input.getStats(); }
+    void resetInputPeaks() { _input.resetPeaks(); }
+
 private:
+    struct PendingCC {
+        uint8_t channel;
+        uint8_t controller;
+        uint8_t value;
+    };
+
     MidiProcessor _processor;
+    MidiInputQueue _input;
+
+    // MIDI message parsing state (input task)
+    MidiStreamParser parser;
+
+    // Bulk-read ring buffer
+    uint8_t ring[SERIAL_MIDI_RING_SIZE];
+    uint16_t ringHead;
+    uint16_t ringCount;
+
+    // Latest value per (channel, CC) within the current batch, in arrival order (loop)
+    PendingCC pendingCC[SERIAL_MIDI_MAX_PENDING_CC];
+    uint8_t pendingCount;
 
-    // MIDI message parsing state
-    uint8_t midiBuffer[3];
-    uint8_t bufferIndex;
-    uint8_t expectedBytes;
-    uint8_t runningStatus;
+    uint32_t messageCount;
+    uint32_t coalescedCount;
     
     // Callbacks
     void (*ccCallback)(uint8_t channel, uint8_t cc, uint8_t value);
@@ -77,13 +114,23 @@ private:
     void (*noteOffCallback)(uint8_t channel, uint8_t note, uint8_t velocity);
     
     // Connection tracking
-    unsigned long lastMessageTime;
-    bool connected;
+    volatile unsigned long lastMessageTime;
+    volatile bool connected;
     
-    // Helper methods
+    // Input side: UART bytes -> timestamped events
+    void poll();
+    static void pollTrampoline(void* context);
+    void fillRing();
+    void drainRing();
     void processMIDIByte(uint8_t byte);
-    void processCompleteMessage();
-    uint8_t getMessageLength(uint8_t status);
+    void processCompleteMessage(const uint8_t* message);
+    void processSysEx(const SysExAssembler& sysex);
+    static void sendSysEx(const uint8_t* data, size_t length, void* context);
+    // Apply side
+    void applyEvent(const MidiInputEvent& event);
+    void queueControlChange(uint8_t channel, uint8_t controller, uint8_t value);
+    void flushPendingCC();
+    void deliverControlChange(uint8_t channel, uint8_t controller, uint8_t value);
 };
 
 #endif // SERIAL_MIDI_HANDLER_H
@@ -0,0 +1,145 @@
+#include "state_sender.h"
+#include <esp_now.h>
+
+static_assert(LeslieProtocol::isValidStartAddress(DMX_START_ADDRESS), "DMX_START_ADDRESS out of range");
+
+namespace {
+
+const uint8_t kBroadcastAddress[ESP_NOW_ETH_ALEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+}
+
+StateSender::StateSender()
+    : _dmx(nullptr)
+    , _clock(nullptr)
+    , _sequence(0)
+    , _framesSent(0)
+    , _keepAlivesSent(0)
+    , _sendErrors(0)
+    , _sentVersion(0)
+    , _hasSent(false)
+    , _lastSendMs(0)
+    , _tempo()
+    , _tempoSync(false)
+    , _tempoDirty(false)
+    , _probeId(0)
+    , _probeReadUs(0)
+    , _probeAppliedUs(0)
+    , _probe()
+    , _probeSent(false) {
+}
+
+bool StateSender::begin(ESPNowDMX* dmx, ESPNowMeshClock* clock) {
+    _dmx = dmx;
+    _clock = clock;
+
+    // MeshClock owns the ESP-NOW driver; make sure broadcasts are allowed
+    // even if it has not registered the broadcast peer itself.
+    if (!esp_now_is_peer_exist(kBroadcastAddress)) {
+        esp_now_peer_info_t peer = {};
+        memcpy(peer.peer_addr, kBroadcastAddress, ESP_NOW_ETH_ALEN);
+        peer.channel = 0;
+        peer.ifidx = WIFI_IF_STA;
+        peer.encrypt = false;
+        if (esp_now_add_peer(&peer) != ESP_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StateSender::update(const uint8_t* dmxData, uint16_t size, uint32_t version, uint32_t nowMs) {
+    uint32_t sinceLast = nowMs - _lastSendMs;
+    bool changed = !_hasSent || version != _sentVersion || _tempoDirty;
+
+    if (changed) {
+        if (_hasSent && sinceLast < DMX_SEND_MIN_INTERVAL_MS) {
+            return false;  // Picked up on a later call once the interval passes
+        }
+    } else if (sinceLast < DMX_KEEPALIVE_MS) {
+        return false;
+    } else {
+        _keepAlivesSent++;
+    }
+
+    send(dmxData, size);
+    _sentVersion = version;
+    _tempoDirty = false;
+    _hasSent = true;
+    _lastSendMs = nowMs;
+    return true;
+}
+
+void StateSender::setTempo(const LeslieProtocol::TempoInfo& tempo, bool sync) {
+    const bool wasLocked = _tempo.beatPeriodUs != 0;
+    const bool locked = tempo.beatPeriodUs != 0;
+    const uint32_t drift = tempo.beatPeriodUs > _tempo.beatPeriodUs
+        ? tempo.beatPeriodUs - _tempo.beatPeriodUs
+        : _tempo.beatPeriodUs - tempo.beatPeriodUs;
+
+    if (sync != _tempoSync || locked != wasLocked || tempo.beatIndex < _tempo.beatIndex ||
+        (locked && drift * 1000ULL > static_cast<uint64_t>(_tempo.beatPeriodUs) * DMX_TEMPO_RESEND_PERMILLE)) {
+        _tempoDirty = true;
+    }
+    _tempo = tempo;
+    _tempoSync = sync;
+}
+
+void StateSender::setLatencyProbe(uint8_t id, uint32_t readUs, uint32_t appliedUs) {
+    if (id == _probeId && readUs == _probeReadUs) {
+        return;
+    }
+    _probeId = id;
+    _probeReadUs = readUs;
+    _probeAppliedUs = appliedUs;
+    _probeSent = false;
+}
+
+void StateSender::send(const uint8_t* dmxData, uint16_t size) {
+    bool ok = true;
+#if DMX_PACKET_MODE == DMX_PACKET_UNIVERSE
+    if (_dmx) {
+        _dmx->sendDMXFrame(dmxData, size);
+    }
+#else
+    ok = sendCompact(dmxData, size);
+#endif
+    if (ok) {
+        _framesSent++;
+    } else {
+        _sendErrors++;
+    }
+}
+
+bool StateSender::sendCompact(const uint8_t* dmxData, uint16_t size) {
+    uint16_t offset = DMX_START_ADDRESS - 1;
+    if (size < offset + LeslieProtocol::kStateChannels) {
+        return false;
+    }
+
+    LeslieProtocol::StatePacket packet;
+    LeslieProtocol::initHeader(packet.header, LeslieProtocol::PACKET_STATE, DMX_UNIVERSE_ID, _sequence++);
+    packet.meshTimeMs = _clock ? _clock->meshMillis() : millis();
+    packet.startAddress = DMX_START_ADDRESS;
+    packet.tempo = _tempo;
+
+    if (_probeId != 0 && !_probeSent) {
+        // Local micros() -> mesh microseconds via the current millisecond
+        // offset, once: the offset moves by 1 ms with clock corrections, and
+        // receivers take changed stamps for a new probe
+        const uint32_t nowUs = micros();
+        const uint32_t meshOffsetUs = _clock ? (_clock->meshMillis() - millis()) * 1000UL : 0;
+        _probe.id = _probeId;
+        _probe.midiReadUs = _probeReadUs + meshOffsetUs;
+        _probe.stateAppliedUs = _probeAppliedUs + meshOffsetUs;
+        _probe.sentUs = nowUs + meshOffsetUs;
+        _probeSent = true;
+    }
+    packet.probe = _probe;
+    if (_tempoSync && _tempo.beatPeriodUs != 0) {
+        packet.header.flags |= LeslieProtocol::kFlagTempoSync;
+    }
+    memcpy(packet.channels, dmxData + offset, LeslieProtocol::kStateChannels);
+
+    return esp_now_send(kBroadcastAddress, reinterpret_cast<const uint8_t*>(&packet), sizeof(packet)) == ESP_OK;
+}
@@ -0,0 +1,65 @@
+#ifndef STATE_SENDER_H
+#define STATE_SENDER_H
+
+#include <Arduino.h>
+#include <ESPNowDMX.h>
+#include <ESPNowMeshClock.h>
+#include <LeslieProtocol.h>
+#include "config.h"
+
+/**
+ * StateSender - Broadcasts the current DMX state over ESP-NOW, either as a
+ * compact LeslieProtocol state packet or as a full ESPNowDMX universe.
+ */
+class StateSender {
+public:
+    StateSender();
+
+    bool begin(ESPNowDMX* dmx, ESPNowMeshClock* clock);
+
+    // Sends when the state version differs from the last one sent
+    // (rate-limited to DMX_SEND_MIN_INTERVAL_MS) or when DMX_KEEPALIVE_MS
+    // has passed without a send. Returns true if a frame went out.
+    bool update(const uint8_t* dmxData, uint16_t size, uint32_t version, uint32_t nowMs);
+    void send(const uint8_t* dmxData, uint16_t size);
+
+    // Tempo carried in compact packets. Lock changes, a tempo change beyond
+    // DMX_TEMPO_RESEND_PERMILLE or a reset beat count send right away; the
+    // steadily advancing beat grid itself rides on regular frames.
+    void setTempo(const LeslieProtocol::TempoInfo& tempo, bool sync);
+
+    // Latest latency probe (local micros() stamps). The first compact
+    // packet after a new id stamps the send time and converts all stamps to
+    // mesh time once; later packets repeat them unchanged.
+    void setLatencyProbe(uint8_t id, uint32_t readUs, uint32_t appliedUs);
+
+    uint32_t getFramesSent() const { return _framesSent; }
+    uint32_t getKeepAlivesSent() const { return _keepAlivesSent; }
+    uint32_t getSendErrors() const { return _sendErrors; }
+
+private:
+    ESPNowDMX* _dmx;
+    ESPNowMeshClock* _clock;
+    uint16_t _sequence;
+    uint32_t _framesSent;
+    uint32_t _keepAlivesSent;
+    uint32_t _sendErrors;
+
+    uint32_t _sentVersion;
+    bool _hasSent;
+    uint32_t _lastSendMs;
+
+    LeslieProtocol::TempoInfo _tempo;
+    bool _tempoSync;
+    bool _tempoDirty;
+
+    uint8_t _probeId;
+    uint32_t _probeReadUs;             // Local micros()
+    uint32_t _probeAppliedUs;
+    LeslieProtocol::ProbeInfo _probe;  // Mesh-time stamps as sent
+    bool _probeSent;
+
+    bool sendCompact(const uint8_t* dmxData, uint16_t size);
+};
+
+#endif // STATE_SENDER_H
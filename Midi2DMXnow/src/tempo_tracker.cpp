@@ -0,0 +1,94 @@
+#include "tempo_tracker.h"
+
+TempoTracker::TempoTracker()
+    : _lastRawUs(0)
+    , _tickTimeUs(0)
+    , _tickPeriodUs(0.0f)
+    , _seedTimeUs(0)
+    , _tickIndex(0)
+    , _lockedTicks(0)
+    , _hasClock(false)
+    , _beatTimeUs(0)
+    , _beatIndex(0)
+    , _resyncs(0) {
+}
+
+void TempoTracker::onClock(uint32_t nowUs) {
+    const uint32_t rawInterval = nowUs - _lastRawUs;
+    const bool stalled = !_hasClock || rawInterval > MIDI_CLOCK_TIMEOUT_MS * 1000UL;
+
+    if (stalled) {
+        // First tick (or clock restarted): nothing to measure yet
+        _tickTimeUs = nowUs;
+        _tickPeriodUs = 0.0f;
+        _lockedTicks = 0;
+    } else if (_tickPeriodUs == 0.0f) {
+        reseed(nowUs);
+        _tickPeriodUs = constrain(static_cast<float>(rawInterval), MIN_TICK_US, MAX_TICK_US);
+    } else {
+        const uint32_t predictedUs = _tickTimeUs + static_cast<uint32_t>(_tickPeriodUs);
+        const float error = static_cast<float>(static_cast<int32_t>(nowUs - predictedUs));
+        if (error > _tickPeriodUs || error < -_tickPeriodUs) {
+            // More than a tick off: tempo jump or lost bytes, start over
+            reseed(nowUs);
+            _tickPeriodUs = constrain(static_cast<float>(rawInterval), MIN_TICK_US, MAX_TICK_US);
+            _resyncs++;
+        } else if (_lockedTicks < TICKS_PER_BEAT) {
+            // Acquisition: the mean interval since seeding is a far better
+            // period estimate than the single interval the loop started from
+            _lockedTicks++;
+            _tickTimeUs = nowUs;
+            _tickPeriodUs = constrain(static_cast<float>(nowUs - _seedTimeUs) / (_lockedTicks + 1),
+                                      MIN_TICK_US, MAX_TICK_US);
+        } else {
+            _tickTimeUs = predictedUs + static_cast<int32_t>(PHASE_GAIN * error);
+            _tickPeriodUs = constrain(_tickPeriodUs + PERIOD_GAIN * error, MIN_TICK_US, MAX_TICK_US);
+            _lockedTicks++;
+        }
+    }
+
+    _lastRawUs = nowUs;
+    _hasClock = true;
+
+    if (_tickIndex % TICKS_PER_BEAT == 0) {
+        _beatTimeUs = _tickTimeUs;
+        _beatIndex = _tickIndex / TICKS_PER_BEAT;
+    }
+    _tickIndex++;
+}
+
+void TempoTracker::reseed(uint32_t nowUs) {
+    _tickTimeUs = nowUs;
+    _seedTimeUs = _lastRawUs;  // Start of the interval that seeds the period
+    _lockedTicks = 0;
+}
+
+void TempoTracker::onStart() {
+    // The next clock is beat 0
+    _tickIndex = 0;
+}
+
+void TempoTracker::onStop() {
+    // Most sources keep sending clock while stopped, so the tempo stays
+    // valid; the beat count is only reset by the next Start.
+}
+
+bool TempoTracker::isLocked(uint32_t nowUs) const {
+    return _hasClock && _tickPeriodUs > 0.0f && _lockedTicks >= TICKS_PER_BEAT &&
+           nowUs - _lastRawUs <= MIDI_CLOCK_TIMEOUT_MS * 1000UL;
+}
+
+float TempoTracker::getBpm() const {
+    return _tickPeriodUs > 0.0f ? 60e6f / (_tickPeriodUs * TICKS_PER_BEAT) : 0.0f;
+}
+
+LeslieProtocol::TempoInfo TempoTracker::getTempoInfo(uint32_t nowUs, uint32_t nowMeshMs) const {
+    LeslieProtocol::TempoInfo tempo = {};
+    if (!isLocked(nowUs)) {
+        return tempo;
+    }
+    tempo.beatPeriodUs = static_cast<uint32_t>(_tickPeriodUs * TICKS_PER_BEAT + 0.5f);
+    tempo.beatIndex = _beatIndex;
+    tempo.beatEpochMs = nowMeshMs - (nowUs - _beatTimeUs) / 1000;
+    return tempo;
+}
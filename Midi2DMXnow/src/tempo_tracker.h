@@ -0,0 +1,62 @@
+#ifndef TEMPO_TRACKER_H
+#define TEMPO_TRACKER_H
+
+#include <Arduino.h>
+#include <LeslieProtocol.h>
+#include "config.h"
+
+/**
+ * TempoTracker - Recovers a steady tempo and beat grid from MIDI clock
+ * (24 ticks per quarter note). Clock bytes arrive with transport and
+ * loop-scheduling jitter, so tick times go through a second-order
+ * delay-locked loop: the phase error of each tick against the prediction
+ * nudges both the filtered tick time and the tick period. Start resets the
+ * beat count so beat 0 is the first clock after Start.
+ *
+ * Feed it from the MIDI path; query it from loop().
+ */
+class TempoTracker {
+public:
+    TempoTracker();
+
+    void onClock(uint32_t nowUs);
+    void onStart();
+    void onStop();
+
+    // Locked once a full beat of consistent clock has been seen, until the
+    // clock stops for MIDI_CLOCK_TIMEOUT_MS
+    bool isLocked(uint32_t nowUs) const;
+    float getBpm() const;
+
+    // Tempo for the state packet: the latest beat expressed in mesh time
+    // (period 0 when unlocked)
+    LeslieProtocol::TempoInfo getTempoInfo(uint32_t nowUs, uint32_t nowMeshMs) const;
+
+    uint32_t getResyncs() const { return _resyncs; }
+
+private:
+    static constexpr uint8_t TICKS_PER_BEAT = 24;
+    // Loop gains: b corrects phase, c = b^2 / 2 (critically damped) the
+    // period; the loop settles in roughly 1 / b = 20 ticks, under a beat
+    static constexpr float PHASE_GAIN = 0.05f;
+    static constexpr float PERIOD_GAIN = PHASE_GAIN * PHASE_GAIN / 2.0f;
+    // 20-300 BPM
+    static constexpr float MIN_TICK_US = 60e6f / (300.0f * TICKS_PER_BEAT);
+    static constexpr float MAX_TICK_US = 60e6f / (20.0f * TICKS_PER_BEAT);
+
+    uint32_t _lastRawUs;     // Arrival time of the previous tick
+    uint32_t _tickTimeUs;    // Filtered time of the latest tick
+    float _tickPeriodUs;     // Filtered tick period, 0 = not seeded
+    uint32_t _seedTimeUs;    // Start of the acquisition window
+    uint32_t _tickIndex;     // Ticks since Start (or the first clock seen)
+    uint32_t _lockedTicks;   // Ticks since the loop was last (re)seeded
+    bool _hasClock;
+
+    uint32_t _beatTimeUs;    // Filtered time of the latest beat
+    uint32_t _beatIndex;
+    uint32_t _resyncs;
+
+    void reseed(uint32_t nowUs);
+};
+
+#endif // TEMPO_TRACKER_H
@@ -0,0 +1,131 @@
+// Throughput benchmark for MidiStreamParser. A Stream stand-in replays a
+// synthetic DIN MIDI capture (CC bursts with running status, notes, clock
+// between and inside messages, the odd SysEx) and the bytes go through the
+// same bulk read -> ring -> parse path as SerialMIDIHandler::poll().
+
+#include "midi_stream_parser.h"
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+// Minimal Arduino Stream: available() and readBytes() over a buffer, at
+// most one UART FIFO (128 bytes) per read
+class ReplayStream {
+public:
+    static constexpr size_t FIFO_BYTES = 128;
+
+    explicit ReplayStream(const std::vector<uint8_t>& data) : _data(data), _position(0) {}
+
+    int available() const {
+        size_t left = _data.size() - _position;
+        return static_cast<int>(left < FIFO_BYTES ? left : FIFO_BYTES);
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t left = _data.size() - _position;
+        if (length > left) {
+            length = left;
+        }
+        memcpy(buffer, _data.data() + _position, length);
+        _position += length;
+        return length;
+    }
+
+    void rewind() { _position = 0; }
+
+private:
+    const std::vector<uint8_t>& _data;
+    size_t _position;
+};
+
+std::vector<uint8_t> makeCapture(size_t messages) {
+    std::vector<uint8_t> data;
+    uint32_t seed = 1;
+    bool needStatus = true;
+    for (size_t i = 0; i < messages; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        const uint8_t r = seed >> 24;
+        if (r < 16) {
+            data.push_back(0x90);
+            data.push_back(r);
+            data.push_back(0x64);
+            needStatus = true;
+        } else {
+            if (needStatus || i % 8 == 0) {
+                data.push_back(0xB0);  // Fresh status now and then; the rest run on it
+                needStatus = false;
+            }
+            data.push_back(r & 0x1F);
+            if (r & 0x20) {
+                data.push_back(0xF8);  // Clock inside the message
+            }
+            data.push_back(r & 0x7F);
+        }
+        if (i % 6 == 0) {
+            data.push_back(0xF8);
+        }
+        if (i % 1000 == 999) {
+            static const uint8_t kSysEx[] = {0xF0, 0x7D, 0x01, 0x02, 0x03, 0x04, 0x05, 0xF7};
+            data.insert(data.end(), kSysEx, kSysEx + sizeof(kSysEx));
+            needStatus = true;
+        }
+    }
+    return data;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const size_t messages = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    const int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    const std::vector<uint8_t> capture = makeCapture(messages);
+    ReplayStream stream(capture);
+
+    MidiStreamParser parser;
+    uint8_t ring[SERIAL_MIDI_RING_SIZE];
+    uint32_t parsed = 0;
+    uint32_t realtime = 0;
+    uint32_t sysex = 0;
+    uint32_t checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        stream.rewind();
+        for (;;) {
+            int available = stream.available();
+            if (available <= 0) {
+                break;
+            }
+            size_t got = stream.readBytes(ring, static_cast<size_t>(available) < sizeof(ring) ? available : sizeof(ring));
+            for (size_t i = 0; i < got; i++) {
+                switch (parser.feed(ring[i])) {
+                    case MidiStreamParser::RESULT_MESSAGE:
+                        parsed++;
+                        checksum += parser.message()[1] + parser.message()[2];
+                        break;
+                    case MidiStreamParser::RESULT_REALTIME:
+                        realtime++;
+                        break;
+                    case MidiStreamParser::RESULT_SYSEX:
+                        sysex++;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double bytes = static_cast<double>(capture.size()) * rounds;
+
+    printf("%u messages, %u real-time, %u SysEx, %u dropped (checksum %u)\n",
+           parsed, realtime, sysex, parser.getDroppedCount(), checksum);
+    printf("%.3f s: %.1f M msgs/s, %.2f ns/byte\n", seconds, parsed / seconds / 1e6, seconds * 1e9 / bytes);
+    return parsed == 0 ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+// Fuzz target for MidiStreamParser. Feeds the input byte by byte and
+// checks what the parser hands out:
+//  - RESULT_MESSAGE: channel voice status 0x80-0xEF, 7-bit data, and data2
+//    is 0 for two-byte messages
+//  - RESULT_REALTIME: 0xF8-0xFF
+//  - RESULT_SYSEX: framed F0 .. F7 with 7-bit data in between, within
+//    MIDI_SYSEX_MAX_BYTES
+// The same input fed again after reset() must give the same results.
+
+#include "midi_stream_parser.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FUZZ_CHECK(cond)                                                   \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            abort();                                                       \
+        }                                                                  \
+    } while (0)
+
+namespace {
+
+// Checks every result and folds it into a checksum for the replay check
+uint32_t parseAll(MidiStreamParser& parser, const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    uint32_t dropped = parser.getDroppedCount();
+    for (size_t i = 0; i < size; i++) {
+        const MidiStreamParser::Result result = parser.feed(data[i]);
+        uint32_t value = result;
+
+        if (result == MidiStreamParser::RESULT_MESSAGE) {
+            const uint8_t* message = parser.message();
+            FUZZ_CHECK(message[0] >= 0x80 && message[0] < 0xF0);
+            FUZZ_CHECK(message[1] < 0x80 && message[2] < 0x80);
+            const uint8_t length = MidiStreamParser::channelMessageLength(message[0]);
+            FUZZ_CHECK(length == 2 || length == 3);
+            FUZZ_CHECK(length == 3 || message[2] == 0);
+            value = (value << 24) | (message[0] << 16) | (message[1] << 8) | message[2];
+        } else if (result == MidiStreamParser::RESULT_REALTIME) {
+            FUZZ_CHECK(parser.realtime() >= 0xF8);
+            FUZZ_CHECK(parser.realtime() == data[i]);
+            value = (value << 24) | parser.realtime();
+        } else if (result == MidiStreamParser::RESULT_SYSEX) {
+            const SysExAssembler& sysex = parser.sysex();
+            const uint8_t length = sysex.length();
+            FUZZ_CHECK(length >= 2 && length <= MIDI_SYSEX_MAX_BYTES);
+            FUZZ_CHECK(sysex.data()[0] == 0xF0 && sysex.data()[length - 1] == 0xF7);
+            FUZZ_CHECK(data[i] == 0xF7);
+            for (uint8_t j = 1; j < length - 1; j++) {
+                FUZZ_CHECK(sysex.data()[j] < 0x80);
+                value = value * 31 + sysex.data()[j];
+            }
+            value = value * 31 + length;
+        } else {
+            FUZZ_CHECK(result == MidiStreamParser::RESULT_NONE);
+        }
+
+        FUZZ_CHECK(parser.getDroppedCount() >= dropped);
+        dropped = parser.getDroppedCount();
+        hash = (hash ^ value) * 16777619u;
+    }
+    return hash;
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    MidiStreamParser parser;
+    const uint32_t first = parseAll(parser, data, size);
+    parser.reset();
+    FUZZ_CHECK(parseAll(parser, data, size) == first);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Stand-in for the libFuzzer driver: runs LLVMFuzzerTestOneInput over the
+// files and directories given on the command line, so the corpus can be
+// checked under plain g++ with the sanitizers.
+
+#include <dirent.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+bool replayFile(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        fprintf(stderr, "can't open %s\n", path.c_str());
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + got);
+    }
+    fclose(file);
+    LLVMFuzzerTestOneInput(data.empty() ? nullptr : data.data(), data.size());
+    return true;
+}
+
+int replayPath(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        fprintf(stderr, "can't stat %s\n", path.c_str());
+        return -1;
+    }
+    if (!S_ISDIR(info.st_mode)) {
+        return replayFile(path) ? 1 : -1;
+    }
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return -1;
+    }
+    int count = 0;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        int result = replayPath(path + "/" + entry->d_name);
+        if (result < 0) {
+            count = -1;
+            break;
+        }
+        count += result;
+    }
+    closedir(dir);
+    return count;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int total = 0;
+    for (int i = 1; i < argc; i++) {
+        int count = replayPath(argv[i]);
+        if (count < 0) {
+            return 1;
+        }
+        total += count;
+    }
+    printf("%d inputs replayed, all checks passed\n", total);
+    return 0;
+}
@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""
+LeslieLEDs MIDI-to-photon latency measurement
+Sends latency probe CCs to the Midi2DMXnow controller (USB or Serial MIDI)
+and reads the PROBE lines a DMXnow2Strip receiver (DEBUG_MODE build) prints
+on its debug console. Every line holds the mesh-clock time of each hop:
+
+    midi    probe CC read by the controller's MIDI input task
+    state   applied to DMXState
+    sent    handed to ESP-NOW
+    rx      received by the node
+    play    played out into DMXToLedEngine
+    engine  handed to LedEngine
+    tx      strip transmit started with the first frame after it
+
+Prints p50/p99/max per hop. Hops that cross nodes (sent -> rx) include the
+mesh clock error, roughly +/-1 ms.
+
+Examples:
+    python test_midi_jitter.py --midi Midi2DMXnow --receiver /dev/ttyUSB1
+    python test_midi_jitter.py --midi-serial /dev/ttyUSB0 --receiver /dev/ttyUSB1 --rate 20
+    python test_midi_jitter.py --from-log receiver.log
+"""
+
+import argparse
+import math
+import re
+import sys
+import threading
+import time
+from typing import Optional
+
+# MIDI Configuration (from config.h)
+MIDI_CHANNEL = 0  # Channel 1 (0-indexed)
+CC_LATENCY_PROBE = 119
+SERIAL_BAUD_RATE = 115200
+
+HOPS = ["midi", "state", "sent", "rx", "play", "engine", "tx"]
+PROBE_LINE = re.compile(r"PROBE id=(\d+)((?: \w+=\d+)+)")
+
+
+def parse_probe(line: str) -> Optional[dict]:
+    """Parse one PROBE line into {'id': n, hop: mesh_us, ...}"""
+    match = PROBE_LINE.search(line)
+    if not match:
+        return None
+    record = {"id": int(match.group(1))}
+    for field in match.group(2).split():
+        key, value = field.split("=")
+        record[key] = int(value)
+    if any(hop not in record for hop in HOPS):
+        return None
+    return record
+
+
+def hop_deltas(record: dict) -> dict:
+    """Per-hop latencies in microseconds (32-bit wrap safe)"""
+    deltas = {}
+    for before, after in zip(HOPS, HOPS[1:]):
+        deltas[f"{before}->{after}"] = _signed32(record[after] - record[before])
+    deltas["total"] = _signed32(record["tx"] - record["midi"])
+    return deltas
+
+
+def _signed32(value: int) -> int:
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def percentile(values: list, fraction: float) -> float:
+    """Nearest-rank percentile"""
+    ordered = sorted(values)
+    rank = max(0, min(len(ordered) - 1, math.ceil(fraction * len(ordered)) - 1))
+    return ordered[rank]
+
+
+def print_report(records: list, sent: int = 0):
+    if not records:
+        print("No complete probes received")
+        return
+
+    samples: dict[str, list] = {}
+    for record in records:
+        for hop, delta in hop_deltas(record).items():
+            samples.setdefault(hop, []).append(delta)
+
+    if sent:
+        print(f"Probes: {sent} sent, {len(records)} complete ({100.0 * len(records) / sent:.1f}%)")
+    else:
+        print(f"Probes: {len(records)} complete")
+    print(f"{'hop':<16}{'p50 ms':>10}{'p99 ms':>10}{'max ms':>10}")
+    for hop, values in samples.items():
+        print(f"{hop:<16}{percentile(values, 0.50) / 1000:>10.2f}"
+              f"{percentile(values, 0.99) / 1000:>10.2f}{max(values) / 1000:>10.2f}")
+
+
+class ProbeSender:
+    """Sends probe CCs over USB MIDI (rtmidi) or raw Serial MIDI"""
+
+    def __init__(self, midi_port: Optional[str], serial_port: Optional[str]):
+        self.midi_out = None
+        self.serial_port = None
+        if serial_port:
+            import serial
+            self.serial_port = serial.Serial(port=serial_port, baudrate=SERIAL_BAUD_RATE, timeout=0.01)
+        else:
+            import rtmidi
+            self.midi_out = rtmidi.MidiOut()
+            ports = self.midi_out.get_ports()
+            matches = [i for i, name in enumerate(ports) if midi_port in name]
+            if not matches:
+                raise RuntimeError(f"No MIDI output matching '{midi_port}' (have: {ports})")
+            self.midi_out.open_port(matches[0])
+
+    def send_probe(self, probe_id: int):
+        message = [0xB0 + MIDI_CHANNEL, CC_LATENCY_PROBE, probe_id]
+        if self.serial_port:
+            self.serial_port.write(bytes(message))
+        else:
+            self.midi_out.send_message(message)
+
+    def close(self):
+        if self.serial_port:
+            self.serial_port.close()
+        if self.midi_out:
+            self.midi_out.close_port()
+
+
+def read_probes(port, records: list, stop: threading.Event, echo: bool):
+    """Collect PROBE lines from the receiver's debug console"""
+    buffer = b""
+    while not stop.is_set():
+        buffer += port.read(256)
+        while b"\n" in buffer:
+            raw, buffer = buffer.split(b"\n", 1)
+            line = raw.decode(errors="replace").strip()
+            record = parse_probe(line)
+            if record:
+                records.append(record)
+            elif echo and line:
+                print(f"  [rx] {line}")
+
+
+def run_live(args) -> int:
+    import serial
+
+    receiver = serial.Serial(port=args.receiver, baudrate=SERIAL_BAUD_RATE, timeout=0.05)
+    sender = ProbeSender(args.midi, args.midi_serial)
+    records: list = []
+    stop = threading.Event()
+    reader = threading.Thread(target=read_probes, args=(receiver, records, stop, args.verbose), daemon=True)
+    reader.start()
+
+    interval = 1.0 / args.rate
+    try:
+        next_send = time.monotonic()
+        for i in range(args.count):
+            # Ids 1-127; 0 means "no probe" on the wire
+            sender.send_probe(i % 127 + 1)
+            next_send += interval
+            time.sleep(max(0.0, next_send - time.monotonic()))
+        time.sleep(args.settle)
+    except KeyboardInterrupt:
+        print("Interrupted")
+    finally:
+        stop.set()
+        reader.join(timeout=1.0)
+        sender.close()
+        receiver.close()
+
+    print_report(records, sent=args.count)
+    return 0 if records else 1
+
+
+def run_from_log(path: str) -> int:
+    with open(path, errors="replace") as log:
+        records = [record for record in map(parse_probe, log) if record]
+    print_report(records)
+    return 0 if records else 1
+
+
+def main():
+    """Main entry point"""
+    parser = argparse.ArgumentParser(description="Measure MIDI-to-LED latency per pipeline hop")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--midi", help="USB MIDI output port name (substring match)")
+    source.add_argument("--midi-serial", help="Serial MIDI port of an M5Core controller")
+    source.add_argument("--from-log", help="Analyze a captured receiver log instead")
+    parser.add_argument("--receiver", help="Receiver debug serial port")
+    parser.add_argument("--count", type=int, default=500, help="Probes to send (default 500)")
+    parser.add_argument("--rate", type=float, default=10.0, help="Probes per second (default 10)")
+    parser.add_argument("--settle", type=float, default=1.0, help="Seconds to wait for the last probes")
+    parser.add_argument("--verbose", action="store_true", help="Echo other receiver console output")
+    args = parser.parse_args()
+
+    if args.from_log:
+        return run_from_log(args.from_log)
+    if not args.receiver:
+        parser.error("--receiver is required for live measurement")
+    return run_live(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())